@@ -11,6 +11,21 @@ struct AlgoResult {
     bool success;
 };
 
-AlgoResult runDijkstra(const IGraph& graph, Node start, Node end, IAlgorithmObserver* observer = nullptr);
+// Priority queue backend for the weighted searches (see PriorityQueues.h)
+enum class QueueKind {
+    BinaryHeap, // Lazy-deletion std::priority_queue
+    DaryHeap,   // Indexed 4-ary heap with decrease-key
+    RadixHeap,  // Monotone radix heap
+    Bucket      // Dial's bucket queue, best for small integer edge costs
+};
+
+const char* queueKindName(QueueKind kind);
+
+AlgoResult runDijkstra(const IGraph& graph, Node start, Node end, IAlgorithmObserver* observer = nullptr, QueueKind queue = QueueKind::BinaryHeap);
 AlgoResult runBFS(const IGraph& graph, Node start, Node end, IAlgorithmObserver* observer = nullptr);
-AlgoResult runAStar(const IGraph& graph, Node start, Node end, IAlgorithmObserver* observer = nullptr);
+AlgoResult runAStar(const IGraph& graph, Node start, Node end, IAlgorithmObserver* observer = nullptr, QueueKind queue = QueueKind::BinaryHeap);
+
+// Bidirectional variants: search from both ends and stop once the frontiers prove optimality.
+// The backward half walks IGraph::getPredecessors.
+AlgoResult runBiDijkstra(const IGraph& graph, Node start, Node end, IAlgorithmObserver* observer = nullptr, QueueKind queue = QueueKind::BinaryHeap);
+AlgoResult runBiAStar(const IGraph& graph, Node start, Node end, IAlgorithmObserver* observer = nullptr, QueueKind queue = QueueKind::BinaryHeap);
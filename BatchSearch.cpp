@@ -0,0 +1,49 @@
+#include "BatchSearch.h"
+#include "SearchKernels.h"
+
+const char* batchAlgorithmName(BatchAlgorithm algorithm) {
+    switch (algorithm) {
+        case BatchAlgorithm::BFS: return "bfs";
+        case BatchAlgorithm::AStar: return "astar";
+        case BatchAlgorithm::BiDijkstra: return "bidijkstra";
+        case BatchAlgorithm::BiAStar: return "biastar";
+        default: return "dijkstra";
+    }
+}
+
+void runBatch(const IGraph& graph, const std::vector<PathQuery>& queries, BatchWorkspace& workspace,
+              BatchResult& result, BatchAlgorithm algorithm, QueueKind queue) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    const int n = (int)queries.size();
+    result.queryCount = n;
+    result.buffer.assign(3 * n + 1, 0);
+    const int pathBase = 3 * n + 1;
+
+    auto record = [&](int i, const AlgoResult& res) {
+        result.buffer[i] = res.success ? res.totalCost : -1;
+        result.buffer[n + i] = res.visitedCount;
+        for (Node v : res.path) result.buffer.push_back(v.id);
+        result.buffer[2 * n + i + 1] = (int)result.buffer.size() - pathBase;
+    };
+
+    // Dispatch once for the whole batch, then loop inside the specialized kernel
+    dispatchQueue(queue, [&](auto tag) {
+        using Q = typename decltype(tag)::type;
+        Q& qf = workspace.queue<Q>(0);
+        Q& qb = workspace.queue<Q>(1);
+        dispatchGraph(graph, nullptr, [&](const auto& view, const auto& sink) {
+            for (int i = 0; i < n; ++i) {
+                Node s = queries[i].source, t = queries[i].target;
+                switch (algorithm) {
+                    case BatchAlgorithm::BFS: record(i, bfsSearch(view, s, t, sink, workspace.forward, workspace.fifo)); break;
+                    case BatchAlgorithm::AStar: record(i, aStarSearch(view, s, t, sink, workspace.forward, qf)); break;
+                    case BatchAlgorithm::BiDijkstra: record(i, bidirectionalSearch<false>(view, s, t, sink, workspace.forward, workspace.backward, qf, qb)); break;
+                    case BatchAlgorithm::BiAStar: record(i, bidirectionalSearch<true>(view, s, t, sink, workspace.forward, workspace.backward, qf, qb)); break;
+                    default: record(i, dijkstraSearch(view, s, t, sink, workspace.forward, qf)); break;
+                }
+            }
+        });
+    });
+
+    result.timeMs = elapsedMs(startTime);
+}
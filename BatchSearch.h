@@ -0,0 +1,57 @@
+#pragma once
+#include "Algorithms.h"
+#include "SearchWorkspace.h"
+#include "PriorityQueues.h"
+#include <tuple>
+#include <vector>
+
+// Many source -> target queries against one graph, without per-query allocation.
+
+enum class BatchAlgorithm { Dijkstra, BFS, AStar, BiDijkstra, BiAStar };
+
+const char* batchAlgorithmName(BatchAlgorithm algorithm);
+
+struct PathQuery {
+    Node source;
+    Node target;
+};
+
+// Search state kept across runBatch calls. Sized on first use; afterwards each
+// query resets it in O(1) (see SearchWorkspace). Holds one queue of every kind,
+// forward and backward, so any QueueKind and algorithm can share it.
+// Not thread-safe: use one workspace per thread.
+class BatchWorkspace {
+public:
+    SearchWorkspace forward;
+    SearchWorkspace backward;
+    std::vector<Node> fifo;
+
+    template <typename Queue>
+    Queue& queue(int side) { return std::get<Queue>(m_queues[side]); }
+
+private:
+    std::tuple<BinaryHeapQueue, DaryHeapQueue<4>, RadixHeapQueue, BucketQueue> m_queues[2];
+};
+
+// All results of a batch in one contiguous int buffer, for n = queryCount:
+//   [0, n)          path cost per query, -1 when the target is unreachable
+//   [n, 2n)         nodes expanded per query
+//   [2n, 3n + 1)    path offsets: query i's path is paths[offset[i] .. offset[i + 1])
+//   [3n + 1, end)   paths: node ids of every path, back to back
+// Passing the same BatchResult to every call reuses its capacity.
+struct BatchResult {
+    std::vector<int> buffer;
+    int queryCount = 0;
+    double timeMs = 0; // Whole batch
+
+    int cost(int i) const { return buffer[i]; }
+    int visited(int i) const { return buffer[queryCount + i]; }
+    int pathLength(int i) const { return buffer[2 * queryCount + i + 1] - buffer[2 * queryCount + i]; }
+    const int* path(int i) const { return buffer.data() + 3 * queryCount + 1 + buffer[2 * queryCount + i]; }
+};
+
+// Answers every query in order. Same costs and paths as the single-query run* functions;
+// observers are not supported (batches are headless).
+void runBatch(const IGraph& graph, const std::vector<PathQuery>& queries, BatchWorkspace& workspace,
+              BatchResult& result, BatchAlgorithm algorithm = BatchAlgorithm::Dijkstra,
+              QueueKind queue = QueueKind::BinaryHeap);
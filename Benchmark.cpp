@@ -0,0 +1,1016 @@
+// Headless benchmark for the search algorithms. Needs neither Win32 nor Emscripten:
+//   g++ -O2 -std=c++17 -pthread Benchmark.cpp Grid.cpp MazeGenerator.cpp Algorithms.cpp BatchSearch.cpp ParallelQueryEngine.cpp
+//       DistanceField.cpp DeltaStepping.cpp ParallelBFS.cpp WorkerPool.cpp Wavefront.cpp JumpPointSearch.cpp
+//       ContractionHierarchy.cpp Landmarks.cpp DStarLite.cpp HierarchicalPathfinder.cpp CsrGraph.cpp MappedFile.cpp
+//       -o benchmark
+// (see build_bench.sh / build_bench.bat)
+//
+// Usage: benchmark [--sizes 100,300,1000] [--families open,maze,weighted,corridor,caves]
+//                  [--algos dijkstra,bfs,astar,...] [--landmarks 16] [--queries 50] [--seed 1]
+//                  [--format csv|json] [--out file]
+//        benchmark --scaling [--threads 1,2,4,8] [same map/query options]
+//        benchmark --sssp [--threads 1,2,4,8,16] [--delta D] [--sizes ...] [--families ...]
+//        benchmark --ch [--witness 256] [--sizes ...] [--families ...] [--queries 50]
+//        benchmark --replan [--queries 50] [--sizes ...] [--families ...]
+//        benchmark --hpa [--cluster 16] [--queries 50] [--sizes ...] [--families ...]
+//        benchmark --csr [--graph road.gr [--coords road.co]] [--queries 50] [--sizes ...] [--families ...]
+//        any of the above with --diagonals for 8-connected (octile) maps
+//
+// Every map and query set is derived from --seed, so two commits can be compared
+// on identical inputs. One row is reported per (family, size, algorithm).
+// astar-alt builds its landmark tables (--landmarks of them) once per map, untimed.
+// --scaling instead times each whole query set through ParallelQueryEngine at every
+// thread count and reports throughput and speedup over one thread.
+// --sssp times a one-to-all distance field from one source: sequential Dijkstra
+// (computeDistanceField) as the baseline, then DeltaSteppingEngine at every thread
+// count, checking each delta-stepping field against the baseline. Unit-weight maps also
+// get the SIMD wavefront field (computeWavefrontField), checked the same way.
+// --ch builds a ContractionHierarchy per map (build time, shortcuts, serialized size),
+// saves it to a file and maps it back, then times the query set against runAStar,
+// counting queries whose cost differs.
+// --replan plans one query with DStarLite, then applies --queries single-cell edits,
+// timing each repair against runAStar from scratch.
+// --hpa builds a HierarchicalPathfinder per map and times the query set, raw and
+// smoothed, against runAStar with the mean and worst suboptimality, then times the
+// incremental rebuild after each of --queries single-cell edits.
+// --csr loads --graph (DIMACS .gr with optional .co, or an edge list), or converts each
+// generated map, into a CsrGraph; times the load, writing the binary cache and mapping
+// it back, then Dijkstra, A* and bidirectional A* on the mapped copy (and runAStar on
+// the grid), counting queries whose costs disagree.
+
+#include "Grid.h"
+#include "Algorithms.h"
+#include "JumpPointSearch.h"
+#include "MazeGenerator.h"
+#include "BatchSearch.h"
+#include "ParallelQueryEngine.h"
+#include "DistanceField.h"
+#include "DeltaStepping.h"
+#include "ParallelBFS.h"
+#include "Wavefront.h"
+#include "ContractionHierarchy.h"
+#include "Landmarks.h"
+#include "DStarLite.h"
+#include "HierarchicalPathfinder.h"
+#include "CsrGraph.h"
+#include "Random.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Peak resident set size per benchmark row, in KiB. ru_maxrss only covers the
+// whole process lifetime, so one row would inherit every earlier row's peak;
+// Linux can restart the high-water mark instead (clear_refs "5", read back as
+// VmHWM). Elsewhere, or if the reset is refused, rows report 0.
+static bool resetPeakRss() {
+#if defined(__linux__)
+    ofstream clear("/proc/self/clear_refs");
+    return clear && (clear << "5" << flush);
+#else
+    return false;
+#endif
+}
+
+static long peakRssKbSinceReset() {
+#if defined(__linux__)
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) return atol(line.c_str() + 6);
+    }
+#endif
+    return 0;
+}
+
+// --- Map families ---
+
+// open: no walls; the other families come from MazeGenerator
+static Grid makeGrid(const string& family, int size, uint64_t seed, bool diagonals) {
+    Grid grid(size, size);
+    grid.setAllowDiagonals(diagonals);
+    MazeOptions options;
+    options.seed = seed;
+    if (family == "maze") options.kind = MazeKind::Noise;
+    else if (family == "weighted") options.kind = MazeKind::Terrain;
+    else if (family == "corridor") options.kind = MazeKind::Backtracker;
+    else if (family == "caves") options.kind = MazeKind::Caves;
+    else return grid;
+    generateMaze(grid, options);
+    return grid;
+}
+
+// Fixed query set: pairs of distinct open cells drawn from the seed
+static vector<pair<Node, Node>> makeQueries(const Grid& grid, int count, uint64_t seed) {
+    Rng rng(seed ^ 0x5bd1e995u);
+    vector<Node> open;
+    auto pick = [&]() {
+        for (int tries = 0; tries < 1000; ++tries) {
+            int x = rng.below(grid.getHeight()), y = rng.below(grid.getWidth());
+            if (!grid.isObstacle(x, y)) return grid.toNode(x, y);
+        }
+        return grid.toNode(0, 0);
+    };
+    vector<pair<Node, Node>> queries;
+    for (int i = 0; i < count; ++i) queries.push_back({ pick(), pick() });
+    return queries;
+}
+
+// --- Algorithms under test ---
+
+struct BenchAlgo {
+    string name;
+    function<AlgoResult(const Grid&, Node, Node)> run;
+    function<void(const Grid&)> prepare = nullptr; // Untimed per-map preprocessing, if any
+};
+
+static vector<BenchAlgo> allAlgorithms(int landmarks) {
+    vector<BenchAlgo> algos;
+    const QueueKind queues[] = { QueueKind::BinaryHeap, QueueKind::DaryHeap, QueueKind::RadixHeap, QueueKind::Bucket };
+    for (QueueKind q : queues) {
+        algos.push_back({ string("dijkstra/") + queueKindName(q), [q](const Grid& g, Node s, Node t) { return runDijkstra(g, s, t, nullptr, q); } });
+    }
+    algos.push_back({ "bfs", [](const Grid& g, Node s, Node t) { return runBFS(g, s, t); } });
+    auto bfsEngine = make_shared<ParallelBFSEngine>();
+    algos.push_back({ "bfs-parallel", [bfsEngine](const Grid& g, Node s, Node t) { return bfsEngine->run(g, s, t); } });
+    for (QueueKind q : queues) {
+        algos.push_back({ string("astar/") + queueKindName(q), [q](const Grid& g, Node s, Node t) { return runAStar(g, s, t, nullptr, q); } });
+    }
+    // ALT: tables built once per map (time reported on stderr), then A* over the LandmarkGraph
+    auto alt = make_shared<unique_ptr<LandmarkGraph>>();
+    algos.push_back({ "astar-alt", [alt](const Grid&, Node s, Node t) { return runAStar(**alt, s, t); },
+                      [alt, landmarks](const Grid& g) {
+        *alt = make_unique<LandmarkGraph>(g);
+        (*alt)->build(landmarks);
+        cerr << "#   astar-alt: " << landmarks << " landmarks in " << (*alt)->buildMs() << " ms, "
+             << (*alt)->tableBytes() << " bytes (" << (*alt)->bytesPerEntry() << " per entry)\n";
+    } });
+    algos.push_back({ "bidijkstra", [](const Grid& g, Node s, Node t) { return runBiDijkstra(g, s, t); } });
+    algos.push_back({ "biastar", [](const Grid& g, Node s, Node t) { return runBiAStar(g, s, t); } });
+    algos.push_back({ "jps", [](const Grid& g, Node s, Node t) { return runJPS(g, s, t); } });
+    // Whole field toward t, then the path read off it from s; Dijkstra's field on weighted maps
+    auto field = make_shared<DistanceField>();
+    algos.push_back({ "wavefront", [field](const Grid& g, Node s, Node t) {
+        if (!computeWavefrontField(g, { t }, *field, FieldMode::ToSources, false)) computeDistanceField(g, { t }, *field);
+        AlgoResult res = { extractFieldPath(g, *field, s, FieldMode::ToSources), field->reachedCount,
+                           max(field->dist[s.id], 0), field->timeMs, field->dist[s.id] >= 0 };
+        return res;
+    } });
+    // Same searches through runBatch with a workspace kept across queries (no per-query allocation)
+    for (BatchAlgorithm a : { BatchAlgorithm::Dijkstra, BatchAlgorithm::AStar }) {
+        auto workspace = make_shared<BatchWorkspace>();
+        auto result = make_shared<BatchResult>();
+        algos.push_back({ string(batchAlgorithmName(a)) + "-batch", [a, workspace, result](const Grid& g, Node s, Node t) {
+            runBatch(g, { { s, t } }, *workspace, *result, a);
+            AlgoResult res = { {}, result->visited(0), max(result->cost(0), 0), result->timeMs, result->cost(0) >= 0 };
+            return res;
+        } });
+    }
+    return algos;
+}
+
+// --- Reporting ---
+
+struct Row {
+    string family;
+    int size;
+    string algo;
+    int queries;
+    int found;
+    double medianMs;
+    double p99Ms;
+    double meanVisited;
+    double nodesPerSec;
+    long peakRssKb;
+};
+
+template <typename F>
+static double timeMs(F&& f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static double percentile(vector<double> v, double p) {
+    if (v.empty()) return 0;
+    sort(v.begin(), v.end());
+    size_t idx = (size_t)(p * (v.size() - 1) + 0.5);
+    return v[min(idx, v.size() - 1)];
+}
+
+static void writeCsv(ostream& out, const vector<Row>& rows) {
+    out << "family,size,algo,queries,found,median_ms,p99_ms,mean_visited,nodes_per_sec,peak_rss_kb\n";
+    for (const auto& r : rows) {
+        out << r.family << "," << r.size << "," << r.algo << "," << r.queries << "," << r.found << ","
+            << r.medianMs << "," << r.p99Ms << "," << r.meanVisited << "," << (long long)r.nodesPerSec << ","
+            << r.peakRssKb << "\n";
+    }
+}
+
+static void writeJson(ostream& out, const vector<Row>& rows) {
+    out << "[\n";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const auto& r = rows[i];
+        out << "  {\"family\": \"" << r.family << "\", \"size\": " << r.size << ", \"algo\": \"" << r.algo
+            << "\", \"queries\": " << r.queries << ", \"found\": " << r.found
+            << ", \"median_ms\": " << r.medianMs << ", \"p99_ms\": " << r.p99Ms
+            << ", \"mean_visited\": " << r.meanVisited << ", \"nodes_per_sec\": " << (long long)r.nodesPerSec
+            << ", \"peak_rss_kb\": " << r.peakRssKb << "}" << (i + 1 < rows.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+struct ScalingRow {
+    string family;
+    int size;
+    string algo;
+    int threads;
+    int queries;
+    double totalMs;
+    double queriesPerSec;
+    double speedup;
+};
+
+static void writeScalingCsv(ostream& out, const vector<ScalingRow>& rows) {
+    out << "family,size,algo,threads,queries,total_ms,queries_per_sec,speedup\n";
+    for (const auto& r : rows) {
+        out << r.family << "," << r.size << "," << r.algo << "," << r.threads << "," << r.queries << ","
+            << r.totalMs << "," << (long long)r.queriesPerSec << "," << r.speedup << "\n";
+    }
+}
+
+static void writeScalingJson(ostream& out, const vector<ScalingRow>& rows) {
+    out << "[\n";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const auto& r = rows[i];
+        out << "  {\"family\": \"" << r.family << "\", \"size\": " << r.size << ", \"algo\": \"" << r.algo
+            << "\", \"threads\": " << r.threads << ", \"queries\": " << r.queries << ", \"total_ms\": " << r.totalMs
+            << ", \"queries_per_sec\": " << (long long)r.queriesPerSec << ", \"speedup\": " << r.speedup << "}"
+            << (i + 1 < rows.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+// Each query set runs once to warm up, then is timed at every thread count
+static vector<ScalingRow> runScaling(const vector<string>& families, const vector<int>& sizes, const vector<int>& threadCounts,
+                                     const vector<string>& algoFilter, int queryCount, uint64_t seed, bool diagonals) {
+    vector<BatchAlgorithm> algos;
+    for (BatchAlgorithm a : { BatchAlgorithm::Dijkstra, BatchAlgorithm::BFS, BatchAlgorithm::AStar, BatchAlgorithm::BiDijkstra, BatchAlgorithm::BiAStar }) {
+        string name = batchAlgorithmName(a);
+        if (algoFilter.empty() ? (a == BatchAlgorithm::Dijkstra || a == BatchAlgorithm::AStar)
+                               : find(algoFilter.begin(), algoFilter.end(), name) != algoFilter.end())
+            algos.push_back(a);
+    }
+
+    vector<ScalingRow> rows;
+    BatchResult result;
+    for (const auto& family : families) {
+        for (int size : sizes) {
+            uint64_t mapSeed = seed * 1000003u + size;
+            Grid grid = makeGrid(family, size, mapSeed, diagonals);
+            vector<PathQuery> queries;
+            for (const auto& q : makeQueries(grid, queryCount, mapSeed)) queries.push_back({ q.first, q.second });
+            cerr << "# " << family << " " << size << "x" << size << ", " << queries.size() << " queries\n";
+            for (BatchAlgorithm a : algos) {
+                double baseMs = 0;
+                for (int threads : threadCounts) {
+                    ParallelQueryEngine engine(threads);
+                    engine.run(grid, queries, result, a);
+                    engine.run(grid, queries, result, a);
+                    if (threads == threadCounts.front()) baseMs = result.timeMs;
+                    double qps = result.timeMs > 0 ? queries.size() / (result.timeMs / 1000.0) : 0;
+                    rows.push_back({ family, size, batchAlgorithmName(a), threads, (int)queries.size(), result.timeMs, qps,
+                                     result.timeMs > 0 ? baseMs / result.timeMs : 0 });
+                    cerr << "#   " << batchAlgorithmName(a) << " x" << threads << ": " << result.timeMs << " ms\n";
+                }
+            }
+        }
+    }
+    return rows;
+}
+
+struct SsspRow {
+    string family;
+    int size;
+    string algo;
+    int threads;
+    int delta;
+    double totalMs;
+    int reached;
+    double nodesPerSec;
+    double speedup;
+    bool match;
+};
+
+static void writeSsspCsv(ostream& out, const vector<SsspRow>& rows) {
+    out << "family,size,algo,threads,delta,total_ms,reached,nodes_per_sec,speedup,match\n";
+    for (const auto& r : rows) {
+        out << r.family << "," << r.size << "," << r.algo << "," << r.threads << "," << r.delta << "," << r.totalMs << ","
+            << r.reached << "," << (long long)r.nodesPerSec << "," << r.speedup << "," << (r.match ? 1 : 0) << "\n";
+    }
+}
+
+static void writeSsspJson(ostream& out, const vector<SsspRow>& rows) {
+    out << "[\n";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const auto& r = rows[i];
+        out << "  {\"family\": \"" << r.family << "\", \"size\": " << r.size << ", \"algo\": \"" << r.algo
+            << "\", \"threads\": " << r.threads << ", \"delta\": " << r.delta << ", \"total_ms\": " << r.totalMs
+            << ", \"reached\": " << r.reached << ", \"nodes_per_sec\": " << (long long)r.nodesPerSec
+            << ", \"speedup\": " << r.speedup << ", \"match\": " << (r.match ? "true" : "false") << "}"
+            << (i + 1 < rows.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+// One source per map, drawn like the query endpoints. Every run is timed once after a warm-up.
+static vector<SsspRow> runSssp(const vector<string>& families, const vector<int>& sizes, const vector<int>& threadCounts,
+                               int delta, uint64_t seed, bool diagonals) {
+    vector<SsspRow> rows;
+    DistanceField baseline, field;
+    for (const auto& family : families) {
+        for (int size : sizes) {
+            uint64_t mapSeed = seed * 1000003u + size;
+            Grid grid = makeGrid(family, size, mapSeed, diagonals);
+            vector<Node> sources = { makeQueries(grid, 1, mapSeed)[0].first };
+            cerr << "# " << family << " " << size << "x" << size << "\n";
+
+            computeDistanceField(grid, sources, baseline);
+            computeDistanceField(grid, sources, baseline);
+            double baseMs = baseline.timeMs;
+            rows.push_back({ family, size, "dijkstra-field", 1, 0, baseMs, baseline.reachedCount,
+                             baseMs > 0 ? baseline.reachedCount / (baseMs / 1000.0) : 0, 1.0, true });
+            cerr << "#   dijkstra-field: " << baseMs << " ms\n";
+
+            if (computeWavefrontField(grid, sources, field)) {
+                computeWavefrontField(grid, sources, field);
+                bool match = field.dist == baseline.dist;
+                rows.push_back({ family, size, string("wavefront/") + wavefrontIsa(), 1, 0, field.timeMs, field.reachedCount,
+                                 field.timeMs > 0 ? field.reachedCount / (field.timeMs / 1000.0) : 0,
+                                 field.timeMs > 0 ? baseMs / field.timeMs : 0, match });
+                cerr << "#   wavefront: " << field.timeMs << " ms" << (match ? "" : " (MISMATCH)") << "\n";
+            }
+
+            for (int threads : threadCounts) {
+                DeltaSteppingEngine engine(threads);
+                engine.run(grid, sources, field, FieldMode::ToSources, delta);
+                engine.run(grid, sources, field, FieldMode::ToSources, delta);
+                bool match = field.dist == baseline.dist;
+                rows.push_back({ family, size, "delta-stepping", threads, engine.lastDelta(), field.timeMs, field.reachedCount,
+                                 field.timeMs > 0 ? field.reachedCount / (field.timeMs / 1000.0) : 0,
+                                 field.timeMs > 0 ? baseMs / field.timeMs : 0, match });
+                cerr << "#   delta-stepping x" << threads << ": " << field.timeMs << " ms" << (match ? "" : " (MISMATCH)") << "\n";
+            }
+        }
+    }
+    return rows;
+}
+
+struct ChRow {
+    string family;
+    int size;
+    int witnessLimit;
+    double buildMs;
+    int shortcuts;
+    size_t indexBytes;
+    bool loaded;
+    int queries;
+    double chMedianMs;
+    double chP99Ms;
+    double chVisited;
+    double astarMedianMs;
+    double astarVisited;
+    double speedup;
+    int mismatches;
+};
+
+static void writeChCsv(ostream& out, const vector<ChRow>& rows) {
+    out << "family,size,witness_limit,build_ms,shortcuts,index_bytes,loaded,queries,ch_median_ms,ch_p99_ms,ch_visited,"
+           "astar_median_ms,astar_visited,speedup,mismatches\n";
+    for (const auto& r : rows) {
+        out << r.family << "," << r.size << "," << r.witnessLimit << "," << r.buildMs << "," << r.shortcuts << ","
+            << r.indexBytes << "," << (r.loaded ? 1 : 0) << "," << r.queries << "," << r.chMedianMs << "," << r.chP99Ms << ","
+            << r.chVisited << "," << r.astarMedianMs << "," << r.astarVisited << "," << r.speedup << "," << r.mismatches << "\n";
+    }
+}
+
+static void writeChJson(ostream& out, const vector<ChRow>& rows) {
+    out << "[\n";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const auto& r = rows[i];
+        out << "  {\"family\": \"" << r.family << "\", \"size\": " << r.size << ", \"witness_limit\": " << r.witnessLimit
+            << ", \"build_ms\": " << r.buildMs << ", \"shortcuts\": " << r.shortcuts << ", \"index_bytes\": " << r.indexBytes
+            << ", \"loaded\": " << (r.loaded ? "true" : "false") << ", \"queries\": " << r.queries
+            << ", \"ch_median_ms\": " << r.chMedianMs << ", \"ch_p99_ms\": " << r.chP99Ms << ", \"ch_visited\": " << r.chVisited
+            << ", \"astar_median_ms\": " << r.astarMedianMs << ", \"astar_visited\": " << r.astarVisited
+            << ", \"speedup\": " << r.speedup << ", \"mismatches\": " << r.mismatches << "}"
+            << (i + 1 < rows.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+// Builds a hierarchy per map, round-trips it through saveFile()/openFile(), then runs the
+// query set on the loaded copy and with runAStar. Every CH cost is checked against A*'s.
+static vector<ChRow> runCh(const vector<string>& families, const vector<int>& sizes, int witnessLimit,
+                           int queryCount, uint64_t seed, bool diagonals) {
+    vector<ChRow> rows;
+    const string indexPath = "benchmark_hierarchy.ch";
+    for (const auto& family : families) {
+        for (int size : sizes) {
+            uint64_t mapSeed = seed * 1000003u + size;
+            Grid grid = makeGrid(family, size, mapSeed, diagonals);
+            auto queries = makeQueries(grid, queryCount, mapSeed);
+            cerr << "# " << family << " " << size << "x" << size << ", " << queries.size() << " queries\n";
+
+            ContractionHierarchy built;
+            auto stats = built.build(grid, witnessLimit);
+            size_t indexBytes = built.serialize().size();
+            bool saved = built.saveFile(indexPath);
+            built = ContractionHierarchy();
+            ContractionHierarchy ch;
+            string error;
+            bool loaded = false;
+            double openMs = timeMs([&] { loaded = saved && ch.openFile(indexPath, &error); });
+            loaded = loaded && ch.matches(grid);
+            cerr << "#   build: " << stats.timeMs << " ms, " << stats.shortcuts << " shortcuts, " << indexBytes << " bytes, opened in "
+                 << openMs << " ms" << (loaded ? "" : " (LOAD FAILED: " + (saved ? error : "cannot write " + indexPath) + ")") << "\n";
+
+            ContractionHierarchy::Workspace workspace;
+            vector<double> chTimes, astarTimes;
+            long long chVisited = 0, astarVisited = 0;
+            int mismatches = 0;
+            for (const auto& q : queries) {
+                AlgoResult fast = ch.query(q.first, q.second, workspace);
+                AlgoResult ref = runAStar(grid, q.first, q.second);
+                chTimes.push_back(fast.timeMs);
+                astarTimes.push_back(ref.timeMs);
+                chVisited += fast.visitedCount;
+                astarVisited += ref.visitedCount;
+                if (fast.success != ref.success || (ref.success && fast.totalCost != ref.totalCost)) ++mismatches;
+            }
+            double n = max<size_t>(queries.size(), 1);
+            double chMedian = percentile(chTimes, 0.5), astarMedian = percentile(astarTimes, 0.5);
+            rows.push_back({ family, size, witnessLimit, stats.timeMs, stats.shortcuts, indexBytes, loaded,
+                             (int)queries.size(), chMedian, percentile(chTimes, 0.99), chVisited / n,
+                             astarMedian, astarVisited / n, chMedian > 0 ? astarMedian / chMedian : 0, mismatches });
+            cerr << "#   query median: ch " << chMedian << " ms, astar " << astarMedian << " ms"
+                 << (mismatches ? " (" + to_string(mismatches) + " MISMATCHES)" : "") << "\n";
+        }
+    }
+    remove(indexPath.c_str());
+    return rows;
+}
+
+struct ReplanRow {
+    string family;
+    int size;
+    int edits;
+    double initialMs;
+    int initialExpanded;
+    double replanMedianMs;
+    double replanExpanded;
+    double astarMedianMs;
+    double astarVisited;
+    double speedup;
+    int mismatches;
+};
+
+static void writeReplanCsv(ostream& out, const vector<ReplanRow>& rows) {
+    out << "family,size,edits,initial_ms,initial_expanded,replan_median_ms,replan_expanded,astar_median_ms,astar_visited,"
+           "speedup,mismatches\n";
+    for (const auto& r : rows) {
+        out << r.family << "," << r.size << "," << r.edits << "," << r.initialMs << "," << r.initialExpanded << ","
+            << r.replanMedianMs << "," << r.replanExpanded << "," << r.astarMedianMs << "," << r.astarVisited << ","
+            << r.speedup << "," << r.mismatches << "\n";
+    }
+}
+
+static void writeReplanJson(ostream& out, const vector<ReplanRow>& rows) {
+    out << "[\n";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const auto& r = rows[i];
+        out << "  {\"family\": \"" << r.family << "\", \"size\": " << r.size << ", \"edits\": " << r.edits
+            << ", \"initial_ms\": " << r.initialMs << ", \"initial_expanded\": " << r.initialExpanded
+            << ", \"replan_median_ms\": " << r.replanMedianMs << ", \"replan_expanded\": " << r.replanExpanded
+            << ", \"astar_median_ms\": " << r.astarMedianMs << ", \"astar_visited\": " << r.astarVisited
+            << ", \"speedup\": " << r.speedup << ", \"mismatches\": " << r.mismatches << "}"
+            << (i + 1 < rows.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+// One query per map, planned once by DStarLite; then each round edits one random cell
+// (wall, clear or reweight) and times the repair against runAStar from scratch
+static vector<ReplanRow> runReplan(const vector<string>& families, const vector<int>& sizes, int rounds,
+                                   uint64_t seed, bool diagonals) {
+    vector<ReplanRow> rows;
+    for (const auto& family : families) {
+        for (int size : sizes) {
+            uint64_t mapSeed = seed * 1000003u + size;
+            Grid grid = makeGrid(family, size, mapSeed, diagonals);
+            // First reachable pair, so the planner is not just flooding a pocket
+            pair<Node, Node> q = makeQueries(grid, 1, mapSeed)[0];
+            for (const auto& candidate : makeQueries(grid, 64, mapSeed)) {
+                if (runBFS(grid, candidate.first, candidate.second).success) {
+                    q = candidate;
+                    break;
+                }
+            }
+            cerr << "# " << family << " " << size << "x" << size << ", " << rounds << " edits\n";
+
+            DStarLite planner(grid);
+            AlgoResult initial = planner.plan(q.first, q.second);
+            Rng rng(mapSeed ^ 0x2545f491u);
+            vector<double> replanTimes, astarTimes;
+            long long expanded = 0, visited = 0;
+            int mismatches = 0;
+            for (int i = 0; i < rounds; ++i) {
+                int x = rng.below(size), y = rng.below(size);
+                switch (rng.below(3)) {
+                case 0: grid.setObstacle(x, y); break;
+                case 1: grid.setEmpty(x, y); break;
+                default: grid.setWeight(x, y, 1 + rng.below(9)); break;
+                }
+                AlgoResult repaired = planner.plan(q.first, q.second);
+                AlgoResult ref = runAStar(grid, q.first, q.second);
+                replanTimes.push_back(repaired.timeMs);
+                astarTimes.push_back(ref.timeMs);
+                expanded += repaired.visitedCount;
+                visited += ref.visitedCount;
+                if (repaired.success != ref.success || repaired.totalCost != ref.totalCost) ++mismatches;
+            }
+            double n = max(rounds, 1);
+            double replanMedian = percentile(replanTimes, 0.5), astarMedian = percentile(astarTimes, 0.5);
+            rows.push_back({ family, size, rounds, initial.timeMs, initial.visitedCount, replanMedian, expanded / n,
+                             astarMedian, visited / n, replanMedian > 0 ? astarMedian / replanMedian : 0, mismatches });
+            cerr << "#   initial " << initial.timeMs << " ms; median repair " << replanMedian << " ms vs astar " << astarMedian
+                 << " ms" << (mismatches ? " (" + to_string(mismatches) + " MISMATCHES)" : "") << "\n";
+        }
+    }
+    return rows;
+}
+
+struct HpaRow {
+    string family;
+    int size;
+    int clusterSize;
+    double buildMs;
+    int entrances;
+    int queries;
+    double hpaMedianMs;
+    double hpaVisited;
+    double smoothMedianMs;
+    double astarMedianMs;
+    double astarVisited;
+    double speedup;
+    double suboptMean;
+    double suboptMax;
+    double smoothSuboptMean;
+    double smoothSuboptMax;
+    double editMedianMs;
+    double editClusters;
+    int mismatches;
+};
+
+static void writeHpaCsv(ostream& out, const vector<HpaRow>& rows) {
+    out << "family,size,cluster_size,build_ms,entrances,queries,hpa_median_ms,hpa_visited,smooth_median_ms,astar_median_ms,"
+           "astar_visited,speedup,subopt_mean,subopt_max,smooth_subopt_mean,smooth_subopt_max,edit_median_ms,edit_clusters,"
+           "mismatches\n";
+    for (const auto& r : rows) {
+        out << r.family << "," << r.size << "," << r.clusterSize << "," << r.buildMs << "," << r.entrances << "," << r.queries
+            << "," << r.hpaMedianMs << "," << r.hpaVisited << "," << r.smoothMedianMs << "," << r.astarMedianMs << ","
+            << r.astarVisited << "," << r.speedup << "," << r.suboptMean << "," << r.suboptMax << "," << r.smoothSuboptMean
+            << "," << r.smoothSuboptMax << "," << r.editMedianMs << "," << r.editClusters << "," << r.mismatches << "\n";
+    }
+}
+
+static void writeHpaJson(ostream& out, const vector<HpaRow>& rows) {
+    out << "[\n";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const auto& r = rows[i];
+        out << "  {\"family\": \"" << r.family << "\", \"size\": " << r.size << ", \"cluster_size\": " << r.clusterSize
+            << ", \"build_ms\": " << r.buildMs << ", \"entrances\": " << r.entrances << ", \"queries\": " << r.queries
+            << ", \"hpa_median_ms\": " << r.hpaMedianMs << ", \"hpa_visited\": " << r.hpaVisited
+            << ", \"smooth_median_ms\": " << r.smoothMedianMs << ", \"astar_median_ms\": " << r.astarMedianMs
+            << ", \"astar_visited\": " << r.astarVisited << ", \"speedup\": " << r.speedup
+            << ", \"subopt_mean\": " << r.suboptMean << ", \"subopt_max\": " << r.suboptMax
+            << ", \"smooth_subopt_mean\": " << r.smoothSuboptMean << ", \"smooth_subopt_max\": " << r.smoothSuboptMax
+            << ", \"edit_median_ms\": " << r.editMedianMs << ", \"edit_clusters\": " << r.editClusters
+            << ", \"mismatches\": " << r.mismatches << "}" << (i + 1 < rows.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+// Builds the abstraction per map, then times the query set raw and smoothed against
+// runAStar. Suboptimality is cost / A* cost - 1 over the queries both solve. Then
+// --queries single-cell edits, timing each incremental rebuild; mismatches counts
+// queries (before and after the edits) where HPA* and A* disagree on reachability.
+static vector<HpaRow> runHpa(const vector<string>& families, const vector<int>& sizes, int clusterSize, int queryCount,
+                             uint64_t seed, bool diagonals) {
+    vector<HpaRow> rows;
+    for (const auto& family : families) {
+        for (int size : sizes) {
+            uint64_t mapSeed = seed * 1000003u + size;
+            Grid grid = makeGrid(family, size, mapSeed, diagonals);
+            auto queries = makeQueries(grid, queryCount, mapSeed);
+            cerr << "# " << family << " " << size << "x" << size << ", " << queries.size() << " queries\n";
+
+            HierarchicalPathfinder hpa(grid, clusterSize);
+            hpa.build();
+            cerr << "#   build: " << hpa.buildMs() << " ms, " << hpa.clusterCount() << " clusters, " << hpa.entranceCount()
+                 << " entrances\n";
+
+            vector<double> hpaTimes, smoothTimes, astarTimes;
+            long long hpaVisited = 0, astarVisited = 0;
+            double subopt = 0, suboptMax = 0, smoothSubopt = 0, smoothSuboptMax = 0;
+            int solved = 0, mismatches = 0;
+            for (const auto& q : queries) {
+                AlgoResult raw = hpa.query(q.first, q.second);
+                AlgoResult smooth = hpa.query(q.first, q.second, true);
+                AlgoResult ref = runAStar(grid, q.first, q.second);
+                hpaTimes.push_back(raw.timeMs);
+                smoothTimes.push_back(smooth.timeMs);
+                astarTimes.push_back(ref.timeMs);
+                hpaVisited += raw.visitedCount;
+                astarVisited += ref.visitedCount;
+                if (raw.success != ref.success) ++mismatches;
+                if (!raw.success || !ref.success || ref.totalCost == 0) continue;
+                double a = (double)raw.totalCost / ref.totalCost - 1, b = (double)smooth.totalCost / ref.totalCost - 1;
+                subopt += a;
+                smoothSubopt += b;
+                suboptMax = max(suboptMax, a);
+                smoothSuboptMax = max(smoothSuboptMax, b);
+                ++solved;
+            }
+
+            Rng rng(mapSeed ^ 0x2545f491u);
+            vector<double> editTimes;
+            long long rebuilt = 0;
+            for (int i = 0; i < queryCount; ++i) {
+                int x = rng.below(size), y = rng.below(size);
+                switch (rng.below(3)) {
+                case 0: grid.setObstacle(x, y); break;
+                case 1: grid.setEmpty(x, y); break;
+                default: grid.setWeight(x, y, 1 + rng.below(9)); break;
+                }
+                hpa.update();
+                editTimes.push_back(hpa.lastUpdateMs());
+                rebuilt += hpa.lastRebuiltClusters();
+            }
+            for (const auto& q : queries) {
+                if (hpa.query(q.first, q.second).success != runAStar(grid, q.first, q.second).success) ++mismatches;
+            }
+
+            double n = max<size_t>(queries.size(), 1), s = max(solved, 1);
+            double hpaMedian = percentile(hpaTimes, 0.5), astarMedian = percentile(astarTimes, 0.5);
+            rows.push_back({ family, size, clusterSize, hpa.buildMs(), hpa.entranceCount(), (int)queries.size(), hpaMedian,
+                             hpaVisited / n, percentile(smoothTimes, 0.5), astarMedian, astarVisited / n,
+                             hpaMedian > 0 ? astarMedian / hpaMedian : 0, subopt / s, suboptMax, smoothSubopt / s,
+                             smoothSuboptMax, percentile(editTimes, 0.5), rebuilt / (double)max(queryCount, 1), mismatches });
+            cerr << "#   query median: hpa " << hpaMedian << " ms, astar " << astarMedian << " ms; suboptimality "
+                 << 100 * subopt / s << "% (" << 100 * smoothSubopt / s << "% smoothed); edit " << percentile(editTimes, 0.5)
+                 << " ms" << (mismatches ? " (" + to_string(mismatches) + " MISMATCHES)" : "") << "\n";
+        }
+    }
+    return rows;
+}
+
+struct CsrRow {
+    string source;
+    int nodes;
+    int edges;
+    double loadMs;
+    double cacheWriteMs;
+    double cacheOpenMs;
+    size_t cacheBytes;
+    int queries;
+    double dijkstraMedianMs;
+    double astarMedianMs;
+    double astarVisited;
+    double biAstarMedianMs;
+    double gridAstarMedianMs;
+    int mismatches;
+};
+
+static void writeCsrCsv(ostream& out, const vector<CsrRow>& rows) {
+    out << "source,nodes,edges,load_ms,cache_write_ms,cache_open_ms,cache_bytes,queries,dijkstra_median_ms,astar_median_ms,"
+           "astar_visited,biastar_median_ms,grid_astar_median_ms,mismatches\n";
+    for (const auto& r : rows) {
+        out << r.source << "," << r.nodes << "," << r.edges << "," << r.loadMs << "," << r.cacheWriteMs << "," << r.cacheOpenMs
+            << "," << r.cacheBytes << "," << r.queries << "," << r.dijkstraMedianMs << "," << r.astarMedianMs << ","
+            << r.astarVisited << "," << r.biAstarMedianMs << "," << r.gridAstarMedianMs << "," << r.mismatches << "\n";
+    }
+}
+
+static void writeCsrJson(ostream& out, const vector<CsrRow>& rows) {
+    out << "[\n";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const auto& r = rows[i];
+        out << "  {\"source\": \"" << r.source << "\", \"nodes\": " << r.nodes << ", \"edges\": " << r.edges
+            << ", \"load_ms\": " << r.loadMs << ", \"cache_write_ms\": " << r.cacheWriteMs
+            << ", \"cache_open_ms\": " << r.cacheOpenMs << ", \"cache_bytes\": " << r.cacheBytes
+            << ", \"queries\": " << r.queries << ", \"dijkstra_median_ms\": " << r.dijkstraMedianMs
+            << ", \"astar_median_ms\": " << r.astarMedianMs << ", \"astar_visited\": " << r.astarVisited
+            << ", \"biastar_median_ms\": " << r.biAstarMedianMs << ", \"grid_astar_median_ms\": " << r.gridAstarMedianMs
+            << ", \"mismatches\": " << r.mismatches << "}" << (i + 1 < rows.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+// Round-trips graph through the cache at cachePath, then times the query set on the
+// mapped copy: Dijkstra (the reference cost), A* and bidirectional A* with the
+// coordinate heuristic, plus runAStar on the original grid when there is one.
+static CsrRow measureCsr(const string& source, CsrGraph& graph, double loadMs, const string& cachePath,
+                         const vector<pair<Node, Node>>& queries, const Grid* grid) {
+    CsrRow row = { source, graph.nodeCount(), graph.edgeCount(), loadMs, 0, 0, graph.memoryBytes(), (int)queries.size(),
+                   0, 0, 0, 0, 0, 0 };
+    bool saved = false, opened = false;
+    row.cacheWriteMs = timeMs([&] { saved = graph.saveCache(cachePath); });
+    CsrGraph mapped;
+    GraphLoadError error;
+    row.cacheOpenMs = timeMs([&] { opened = saved && mapped.openCache(cachePath, &error); });
+    if (!opened) cerr << "#   cache round trip failed: " << (saved ? error.message : "cannot write " + cachePath) << "\n";
+    const CsrGraph& g = opened ? mapped : graph;
+    cerr << "#   " << g.nodeCount() << " nodes, " << g.edgeCount() << " arcs; load " << loadMs << " ms, cache write "
+         << row.cacheWriteMs << " ms, reopen " << row.cacheOpenMs << " ms\n";
+
+    vector<double> dijkstraTimes, astarTimes, biTimes, gridTimes;
+    long long visited = 0;
+    for (const auto& q : queries) {
+        AlgoResult ref = runDijkstra(g, q.first, q.second);
+        AlgoResult astar = runAStar(g, q.first, q.second);
+        AlgoResult bi = runBiAStar(g, q.first, q.second);
+        dijkstraTimes.push_back(ref.timeMs);
+        astarTimes.push_back(astar.timeMs);
+        biTimes.push_back(bi.timeMs);
+        visited += astar.visitedCount;
+        bool match = astar.success == ref.success && bi.success == ref.success &&
+                     (!ref.success || (astar.totalCost == ref.totalCost && bi.totalCost == ref.totalCost));
+        if (grid) {
+            AlgoResult onGrid = runAStar(*grid, q.first, q.second);
+            gridTimes.push_back(onGrid.timeMs);
+            match = match && onGrid.success == ref.success && (!ref.success || onGrid.totalCost == ref.totalCost);
+        }
+        if (!match) ++row.mismatches;
+    }
+    row.dijkstraMedianMs = percentile(dijkstraTimes, 0.5);
+    row.astarMedianMs = percentile(astarTimes, 0.5);
+    row.astarVisited = queries.empty() ? 0 : (double)visited / queries.size();
+    row.biAstarMedianMs = percentile(biTimes, 0.5);
+    row.gridAstarMedianMs = grid ? percentile(gridTimes, 0.5) : 0;
+    cerr << "#   query median: dijkstra " << row.dijkstraMedianMs << " ms, astar " << row.astarMedianMs << " ms, bi-astar "
+         << row.biAstarMedianMs << " ms" << (row.mismatches ? " (" + to_string(row.mismatches) + " MISMATCHES)" : "") << "\n";
+    return row;
+}
+
+// With graphPath: a DIMACS .gr (plus coordsPath, a .co) or an edge list, cached next to
+// it. Otherwise every generated map is converted to a CsrGraph with cell coordinates.
+static vector<CsrRow> runCsr(const string& graphPath, const string& coordsPath, const vector<string>& families,
+                             const vector<int>& sizes, int queryCount, uint64_t seed, bool diagonals) {
+    vector<CsrRow> rows;
+    if (!graphPath.empty()) {
+        CsrGraph graph;
+        GraphLoadError error;
+        bool dimacs = graphPath.size() > 3 && graphPath.compare(graphPath.size() - 3, 3, ".gr") == 0;
+        bool loaded = false;
+        double loadMs = timeMs([&] {
+            loaded = dimacs ? graph.loadDimacsFile(graphPath, coordsPath, &error) : graph.loadEdgeListFile(graphPath, false, &error);
+        });
+        cerr << "# " << graphPath << "\n";
+        if (!loaded) {
+            cerr << "#   load failed at byte " << error.offset << ": " << error.message << "\n";
+            return rows;
+        }
+        Rng rng(seed ^ 0x5bd1e995u);
+        vector<pair<Node, Node>> queries;
+        for (int i = 0; i < queryCount && graph.nodeCount() > 0; ++i) {
+            queries.push_back({ Node{ (int)rng.below(graph.nodeCount()) }, Node{ (int)rng.below(graph.nodeCount()) } });
+        }
+        rows.push_back(measureCsr(graphPath, graph, loadMs, graphPath + ".csr", queries, nullptr));
+        return rows;
+    }
+    const string cachePath = "benchmark_graph.csr";
+    for (const auto& family : families) {
+        for (int size : sizes) {
+            uint64_t mapSeed = seed * 1000003u + size;
+            Grid grid = makeGrid(family, size, mapSeed, diagonals);
+            auto queries = makeQueries(grid, queryCount, mapSeed);
+            cerr << "# " << family << " " << size << "x" << size << ", " << queries.size() << " queries\n";
+            CsrGraph graph;
+            double loadMs = timeMs([&] {
+                graph.build(grid);
+                vector<int32_t> x(grid.nodeCount()), y(grid.nodeCount());
+                for (int v = 0; v < grid.nodeCount(); ++v) {
+                    x[v] = v / size;
+                    y[v] = v % size;
+                }
+                graph.setCoordinates(x, y);
+            });
+            rows.push_back(measureCsr(family + "-" + to_string(size), graph, loadMs, cachePath, queries, &grid));
+        }
+    }
+    remove(cachePath.c_str());
+    return rows;
+}
+
+static vector<string> splitList(const string& s) {
+    vector<string> items;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ',')) if (!item.empty()) items.push_back(item);
+    return items;
+}
+
+int main(int argc, char** argv) {
+    vector<int> sizes = { 100, 300, 1000 };
+    vector<string> families = { "open", "maze", "weighted", "corridor", "caves" };
+    vector<string> algoFilter;
+    int queryCount = 50;
+    uint64_t seed = 1;
+    string format = "csv";
+    string outPath;
+    bool scaling = false;
+    bool sssp = false;
+    bool ch = false;
+    bool replan = false;
+    bool hpa = false;
+    int clusterSize = 16;
+    bool csr = false;
+    string graphPath, coordsPath;
+    int witnessLimit = 256;
+    int landmarks = 16;
+    bool diagonals = false;
+    int delta = 0;
+    vector<int> threadCounts;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        string val = (i + 1 < argc) ? argv[i + 1] : "";
+        if (arg == "--sizes") { sizes.clear(); for (auto& s : splitList(val)) sizes.push_back(stoi(s)); ++i; }
+        else if (arg == "--families") { families = splitList(val); ++i; }
+        else if (arg == "--algos") { algoFilter = splitList(val); ++i; }
+        else if (arg == "--queries") { queryCount = stoi(val); ++i; }
+        else if (arg == "--seed") { seed = stoull(val); ++i; }
+        else if (arg == "--format") { format = val; ++i; }
+        else if (arg == "--out") { outPath = val; ++i; }
+        else if (arg == "--scaling") { scaling = true; }
+        else if (arg == "--sssp") { sssp = true; }
+        else if (arg == "--ch") { ch = true; }
+        else if (arg == "--replan") { replan = true; }
+        else if (arg == "--hpa") { hpa = true; }
+        else if (arg == "--cluster") { clusterSize = stoi(val); ++i; }
+        else if (arg == "--csr") { csr = true; }
+        else if (arg == "--graph") { graphPath = val; ++i; }
+        else if (arg == "--coords") { coordsPath = val; ++i; }
+        else if (arg == "--landmarks") { landmarks = stoi(val); ++i; }
+        else if (arg == "--witness") { witnessLimit = stoi(val); ++i; }
+        else if (arg == "--delta") { delta = stoi(val); ++i; }
+        else if (arg == "--diagonals") { diagonals = true; }
+        else if (arg == "--threads") { for (auto& t : splitList(val)) threadCounts.push_back(stoi(t)); ++i; }
+        else {
+            cerr << "Usage: " << argv[0] << " [--sizes 100,300,1000] [--families open,maze,weighted,corridor,caves]"
+                 << " [--algos dijkstra/binary,bfs,...] [--landmarks K] [--queries N] [--seed S] [--format csv|json] [--out file]"
+                 << " [--scaling [--threads 1,2,4]] [--sssp [--threads 1,2,4,8,16] [--delta D]]"
+                 << " [--ch [--witness N]] [--replan] [--hpa [--cluster N]] [--csr [--graph file.gr [--coords file.co]]]"
+                 << " [--diagonals]\n";
+            return 1;
+        }
+    }
+
+    if (sssp) {
+        if (threadCounts.empty()) threadCounts = { 1, 2, 4, 8, 16 };
+        auto rows = runSssp(families, sizes, threadCounts, delta, seed, diagonals);
+        ofstream file;
+        if (!outPath.empty()) file.open(outPath);
+        ostream& out = outPath.empty() ? cout : file;
+        if (format == "json") writeSsspJson(out, rows);
+        else writeSsspCsv(out, rows);
+        return 0;
+    }
+
+    if (replan) {
+        auto rows = runReplan(families, sizes, queryCount, seed, diagonals);
+        ofstream file;
+        if (!outPath.empty()) file.open(outPath);
+        ostream& out = outPath.empty() ? cout : file;
+        if (format == "json") writeReplanJson(out, rows);
+        else writeReplanCsv(out, rows);
+        return 0;
+    }
+
+    if (csr) {
+        auto rows = runCsr(graphPath, coordsPath, families, sizes, queryCount, seed, diagonals);
+        ofstream file;
+        if (!outPath.empty()) file.open(outPath);
+        ostream& out = outPath.empty() ? cout : file;
+        if (format == "json") writeCsrJson(out, rows);
+        else writeCsrCsv(out, rows);
+        return 0;
+    }
+
+    if (hpa) {
+        auto rows = runHpa(families, sizes, clusterSize, queryCount, seed, diagonals);
+        ofstream file;
+        if (!outPath.empty()) file.open(outPath);
+        ostream& out = outPath.empty() ? cout : file;
+        if (format == "json") writeHpaJson(out, rows);
+        else writeHpaCsv(out, rows);
+        return 0;
+    }
+
+    if (ch) {
+        auto rows = runCh(families, sizes, witnessLimit, queryCount, seed, diagonals);
+        ofstream file;
+        if (!outPath.empty()) file.open(outPath);
+        ostream& out = outPath.empty() ? cout : file;
+        if (format == "json") writeChJson(out, rows);
+        else writeChCsv(out, rows);
+        return 0;
+    }
+
+    if (scaling) {
+        if (threadCounts.empty()) {
+            // 1, 2, 4, ... up to the core count
+            int cores = max(1, (int)thread::hardware_concurrency());
+            for (int t = 1; t < cores; t *= 2) threadCounts.push_back(t);
+            threadCounts.push_back(cores);
+        }
+        auto rows = runScaling(families, sizes, threadCounts, algoFilter, queryCount, seed, diagonals);
+        ofstream file;
+        if (!outPath.empty()) file.open(outPath);
+        ostream& out = outPath.empty() ? cout : file;
+        if (format == "json") writeScalingJson(out, rows);
+        else writeScalingCsv(out, rows);
+        return 0;
+    }
+
+    vector<BenchAlgo> algos;
+    for (auto& a : allAlgorithms(landmarks)) {
+        bool wanted = algoFilter.empty();
+        for (auto& f : algoFilter) wanted = wanted || a.name == f || a.name.rfind(f + "/", 0) == 0;
+        if (wanted) algos.push_back(a);
+    }
+
+    vector<Row> rows;
+    for (const auto& family : families) {
+        for (int size : sizes) {
+            uint64_t mapSeed = seed * 1000003u + size;
+            Grid grid = makeGrid(family, size, mapSeed, diagonals);
+            auto queries = makeQueries(grid, queryCount, mapSeed);
+            cerr << "# " << family << " " << size << "x" << size << ", " << queries.size() << " queries\n";
+
+            // Fastest queue backend per weighted algorithm, by median latency
+            map<string, pair<double, string>> bestQueue;
+            for (const auto& algo : algos) {
+                bool measuredRss = resetPeakRss();
+                if (algo.prepare) algo.prepare(grid);
+                vector<double> times;
+                long long visited = 0;
+                double totalMs = 0;
+                int found = 0;
+                for (const auto& q : queries) {
+                    AlgoResult res = algo.run(grid, q.first, q.second);
+                    times.push_back(res.timeMs);
+                    totalMs += res.timeMs;
+                    visited += res.visitedCount;
+                    found += res.success;
+                }
+                Row row = { family, size, algo.name, (int)queries.size(), found,
+                            percentile(times, 0.5), percentile(times, 0.99),
+                            queries.empty() ? 0 : (double)visited / queries.size(),
+                            totalMs > 0 ? visited / (totalMs / 1000.0) : 0, measuredRss ? peakRssKbSinceReset() : 0 };
+                rows.push_back(row);
+
+                size_t slash = algo.name.find('/');
+                if (slash != string::npos) {
+                    string base = algo.name.substr(0, slash);
+                    auto it = bestQueue.find(base);
+                    if (it == bestQueue.end() || row.medianMs < it->second.first)
+                        bestQueue[base] = { row.medianMs, algo.name.substr(slash + 1) };
+                }
+            }
+            for (const auto& b : bestQueue) {
+                cerr << "#   fastest queue for " << b.first << ": " << b.second.second << " (" << b.second.first << " ms median)\n";
+            }
+        }
+    }
+
+    ofstream file;
+    if (!outPath.empty()) file.open(outPath);
+    ostream& out = outPath.empty() ? cout : file;
+    if (format == "json") writeJson(out, rows);
+    else writeCsv(out, rows);
+    return 0;
+}
@@ -2,27 +2,42 @@
 #include <emscripten/val.h>
 #include <vector>
 #include <string>
+#include <iostream>
 #include <chrono>
 #include "Grid.h"
 #include "Algorithms.h"
+#include "JumpPointSearch.h"
+#include "MazeGenerator.h"
+#include "BatchSearch.h"
+#include "DistanceField.h"
+#include "Wavefront.h"
+#include "DStarLite.h"
 
 using namespace emscripten;
 
-// Result structure specifically formatted for the JS interface
+// Result structure specifically formatted for the JS interface.
+// Path and visited order are flat node ids (x * width + y) exposed to JS as
+// Int32Array views over Wasm memory, so JS reads them without one embind call
+// per element. Views are invalidated by memory growth or delete(); copy them
+// with slice() before running anything else.
 struct WasmResult {
-    std::vector<Point> path;
-    std::vector<Point> visited;
+    std::vector<int> path;
+    std::vector<int> visited;
     double timeMs;
     bool success;
+
+    val pathView() const { return val(typed_memory_view(path.size(), path.data())); }
+    val visitedView() const { return val(typed_memory_view(visited.size(), visited.data())); }
 };
 
 // Wasm Implementation of the Observer to capture steps for the frontend animation
 class WasmObserver : public IAlgorithmObserver {
 public:
-    WasmObserver(const Grid& grid) : m_grid(grid) {}
+    // Only the visited order is sent to JS, so skip log formatting entirely
+    unsigned capabilities() const override { return VISITED; }
     
     void onNodeVisited(Node n) override {
-        visited.push_back(m_grid.toPoint(n));
+        visited.push_back(n.id);
     }
     
     void onNodeCurrent(Node n) override {
@@ -33,63 +48,181 @@ public:
         // Optional: send logs back to JS via emscripten::val if needed
     }
 
-    std::vector<Point> visited;
-
-private:
-    const Grid& m_grid;
+    std::vector<int> visited;
 };
 
 // Helper to convert core result to JS-friendly structure
-WasmResult convertResult(const AlgoResult& res, const Grid& grid, const std::vector<Point>& visited) {
+WasmResult convertResult(const AlgoResult& res, std::vector<int>&& visited) {
     WasmResult wr;
-    wr.visited = visited;
+    wr.visited = std::move(visited);
     wr.timeMs = res.timeMs;
     wr.success = res.success;
+    wr.path.reserve(res.path.size());
     for (auto n : res.path) {
-        wr.path.push_back(grid.toPoint(n));
+        wr.path.push_back(n.id);
     }
     return wr;
 }
 
 WasmResult solveDijkstra(Grid& grid) {
-    WasmObserver observer(grid);
+    WasmObserver observer;
     Node start = grid.toNode(grid.getSource().x, grid.getSource().y);
     Node end = grid.toNode(grid.getDestination().x, grid.getDestination().y);
     
     AlgoResult res = runDijkstra(grid, start, end, &observer);
-    return convertResult(res, grid, observer.visited);
+    return convertResult(res, std::move(observer.visited));
 }
 
 WasmResult solveBFS(Grid& grid) {
-    WasmObserver observer(grid);
+    WasmObserver observer;
     Node start = grid.toNode(grid.getSource().x, grid.getSource().y);
     Node end = grid.toNode(grid.getDestination().x, grid.getDestination().y);
     
     AlgoResult res = runBFS(grid, start, end, &observer);
-    return convertResult(res, grid, observer.visited);
+    return convertResult(res, std::move(observer.visited));
 }
 
 WasmResult solveAStar(Grid& grid) {
-    WasmObserver observer(grid);
+    WasmObserver observer;
     Node start = grid.toNode(grid.getSource().x, grid.getSource().y);
     Node end = grid.toNode(grid.getDestination().x, grid.getDestination().y);
     
     AlgoResult res = runAStar(grid, start, end, &observer);
-    return convertResult(res, grid, observer.visited);
+    return convertResult(res, std::move(observer.visited));
+}
+
+WasmResult solveBiDijkstra(Grid& grid) {
+    WasmObserver observer;
+    Node start = grid.toNode(grid.getSource().x, grid.getSource().y);
+    Node end = grid.toNode(grid.getDestination().x, grid.getDestination().y);
+    
+    AlgoResult res = runBiDijkstra(grid, start, end, &observer);
+    return convertResult(res, std::move(observer.visited));
+}
+
+WasmResult solveBiAStar(Grid& grid) {
+    WasmObserver observer;
+    Node start = grid.toNode(grid.getSource().x, grid.getSource().y);
+    Node end = grid.toNode(grid.getDestination().x, grid.getDestination().y);
+    
+    AlgoResult res = runBiAStar(grid, start, end, &observer);
+    return convertResult(res, std::move(observer.visited));
 }
 
+WasmResult solveJPS(Grid& grid) {
+    WasmObserver observer;
+    Node start = grid.toNode(grid.getSource().x, grid.getSource().y);
+    Node end = grid.toNode(grid.getDestination().x, grid.getDestination().y);
+    
+    AlgoResult res = runJPS(grid, start, end, &observer);
+    return convertResult(res, std::move(observer.visited));
+}
+
+// Keep one DStarLite per grid alive across runs: it hears the grid's edits and
+// repairs its previous search instead of starting over
+WasmResult solveDStarLite(Grid& grid, DStarLite& planner) {
+    WasmObserver observer;
+    Node start = grid.toNode(grid.getSource().x, grid.getSource().y);
+    Node end = grid.toNode(grid.getDestination().x, grid.getDestination().y);
+
+    AlgoResult res = planner.plan(start, end, &observer);
+    return convertResult(res, std::move(observer.visited));
+}
+
+// kind is a MazeKind index; seed 0 picks a fresh one. Returns the seed used so the map can be
+// regenerated (32-bit, since 64-bit integers would surface as BigInt in JS).
+unsigned generateRandomMaze(Grid& grid, int kind, unsigned seed) {
+    if (seed == 0) seed = (unsigned)std::chrono::steady_clock::now().time_since_epoch().count() | 1;
+    MazeOptions options;
+    options.kind = (kind >= 0 && kind <= (int)MazeKind::Terrain) ? (MazeKind)kind : MazeKind::Noise;
+    options.seed = seed;
+    generateMaze(grid, options);
+    return seed;
+}
+
+// Accepts a JS string or a Uint8Array (binary maps); failures are reported on the console
+bool loadGrid(Grid& grid, const std::string& data) {
+    GridLoadError error;
+    if (grid.load(data, &error)) return true;
+    std::cerr << "Grid load failed at byte " << error.offset << ": " << error.message << std::endl;
+    return false;
+}
+
+// Batch queries: queries holds node ids as [source0, target0, source1, target1, ...].
+// Keep one BatchWorkspace and BatchResult alive across calls so nothing is reallocated.
+// Returns false (and runs nothing) if any id is outside the grid.
+bool solveBatch(Grid& grid, BatchWorkspace& workspace, BatchResult& result, val queries, int algorithm, int queue) {
+    std::vector<int> ids = vecFromJSArray<int>(queries);
+    std::vector<PathQuery> batch;
+    batch.reserve(ids.size() / 2);
+    for (size_t i = 0; i + 1 < ids.size(); i += 2) {
+        if (ids[i] < 0 || ids[i] >= grid.nodeCount() || ids[i + 1] < 0 || ids[i + 1] >= grid.nodeCount()) return false;
+        batch.push_back({ { ids[i] }, { ids[i + 1] } });
+    }
+    runBatch(grid, batch, workspace, result, (BatchAlgorithm)algorithm, (QueueKind)queue);
+    return true;
+}
+
+// Int32Array over the whole result buffer (layout in BatchSearch.h). Same lifetime
+// rules as WasmResult's views: invalid after the next batch or memory growth.
+val batchBufferView(const BatchResult& result) {
+    return val(typed_memory_view(result.buffer.size(), result.buffer.data()));
+}
+
+// JS array of node ids; false if any is outside the grid
+static bool fieldSources(const Grid& grid, val sources, std::vector<Node>& nodes) {
+    std::vector<int> ids = vecFromJSArray<int>(sources);
+    nodes.reserve(ids.size());
+    for (int id : ids) {
+        if (id < 0 || id >= grid.nodeCount()) return false;
+        nodes.push_back({ id });
+    }
+    return true;
+}
+
+// Distance field around sources (node ids). towardSources gives the flow field
+// agents follow to the nearest source; otherwise the shortest-path tree from them.
+// Reuse one DistanceField across calls. Returns false if any id is outside the grid.
+bool computeField(Grid& grid, DistanceField& field, val sources, bool towardSources, int queue) {
+    std::vector<Node> nodes;
+    if (!fieldSources(grid, sources, nodes)) return false;
+    computeDistanceField(grid, nodes, field, towardSources ? FieldMode::ToSources : FieldMode::FromSources, (QueueKind)queue);
+    return true;
+}
+
+// Same field through the SIMD wavefront sweeps; weighted grids fall back to computeField's Dijkstra
+bool computeWavefront(Grid& grid, DistanceField& field, val sources, bool towardSources) {
+    std::vector<Node> nodes;
+    if (!fieldSources(grid, sources, nodes)) return false;
+    FieldMode mode = towardSources ? FieldMode::ToSources : FieldMode::FromSources;
+    if (!computeWavefrontField(grid, nodes, field, mode)) computeDistanceField(grid, nodes, field, mode);
+    return true;
+}
+
+// Path read off a field from node `from` (see extractFieldPath); no visited order
+WasmResult solveFieldPath(Grid& grid, const DistanceField& field, int from, bool towardSources) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::vector<Node> path = extractFieldPath(grid, field, Node{ from }, towardSources ? FieldMode::ToSources : FieldMode::FromSources);
+    AlgoResult res = { path, (int)path.size(), path.empty() ? 0 : field.dist[from], 0, !path.empty() };
+    res.timeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    return convertResult(res, {});
+}
+
+// Int32Array / Int8Array views over the field, same lifetime rules as batchBufferView
+val fieldDistView(const DistanceField& field) { return val(typed_memory_view(field.dist.size(), field.dist.data())); }
+val fieldParentView(const DistanceField& field) { return val(typed_memory_view(field.parent.size(), field.parent.data())); }
+val fieldDirectionView(const DistanceField& field) { return val(typed_memory_view(field.direction.size(), field.direction.data())); }
+
 EMSCRIPTEN_BINDINGS(my_module) {
     value_object<Point>("Point")
         .field("x", &Point::x)
         .field("y", &Point::y);
 
-    value_object<WasmResult>("AlgoResult")
-        .field("path", &WasmResult::path)
-        .field("visited", &WasmResult::visited)
-        .field("timeMs", &WasmResult::timeMs)
-        .field("success", &WasmResult::success);
-
-    register_vector<Point>("vector<Point>");
+    class_<WasmResult>("AlgoResult")
+        .function("pathView", &WasmResult::pathView)
+        .function("visitedView", &WasmResult::visitedView)
+        .property("timeMs", &WasmResult::timeMs)
+        .property("success", &WasmResult::success);
     
     class_<Grid>("Grid")
         .constructor<int, int>()
@@ -104,12 +237,38 @@ EMSCRIPTEN_BINDINGS(my_module) {
         .function("setEmpty", &Grid::setEmpty)
         .function("setAllowDiagonals", &Grid::setAllowDiagonals)
         .function("getAllowDiagonals", &Grid::getAllowDiagonals)
-        .function("generateRandomMaze", &Grid::generateRandomMaze)
+        .function("generateRandomMaze", &generateRandomMaze)
         .function("serialize", &Grid::serialize)
-        .function("load", &Grid::load)
-        .function("clearPath", &Grid::clearPath);
+        .function("load", &loadGrid);
 
     function("solveDijkstra", &solveDijkstra);
     function("solveBFS", &solveBFS);
     function("solveAStar", &solveAStar);
+    function("solveBiDijkstra", &solveBiDijkstra);
+    function("solveBiAStar", &solveBiAStar);
+    function("solveJPS", &solveJPS);
+
+    class_<DStarLite>("DStarLite")
+        .constructor<Grid&>();
+    function("solveDStarLite", &solveDStarLite);
+
+    class_<BatchWorkspace>("BatchWorkspace")
+        .constructor<>();
+    class_<BatchResult>("BatchResult")
+        .constructor<>()
+        .function("bufferView", &batchBufferView)
+        .property("queryCount", &BatchResult::queryCount)
+        .property("timeMs", &BatchResult::timeMs);
+    function("solveBatch", &solveBatch);
+
+    class_<DistanceField>("DistanceField")
+        .constructor<>()
+        .function("distView", &fieldDistView)
+        .function("parentView", &fieldParentView)
+        .function("directionView", &fieldDirectionView)
+        .property("reachedCount", &DistanceField::reachedCount)
+        .property("timeMs", &DistanceField::timeMs);
+    function("computeField", &computeField);
+    function("computeWavefront", &computeWavefront);
+    function("solveFieldPath", &solveFieldPath);
 }
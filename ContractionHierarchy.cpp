@@ -0,0 +1,467 @@
+#include "ContractionHierarchy.h"
+#include "SearchKernels.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <queue>
+
+namespace {
+
+// FNV-1a over every edge in getNeighbors order, so any edit changes it
+uint64_t hashGraph(const IGraph& graph) {
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&](uint32_t v) {
+        for (int i = 0; i < 4; ++i) {
+            h ^= (v >> (8 * i)) & 0xFF;
+            h *= 1099511628211ull;
+        }
+    };
+    const int n = graph.nodeCount();
+    mix((uint32_t)n);
+    std::vector<Edge> edges;
+    for (int u = 0; u < n; ++u) {
+        graph.getNeighbors(Node{ u }, edges);
+        mix((uint32_t)edges.size());
+        for (const Edge& e : edges) {
+            mix((uint32_t)e.target.id);
+            mix((uint32_t)e.weight);
+        }
+    }
+    return h;
+}
+
+// The graph being contracted. Each node lists its out-arcs, then its in-arcs;
+// once a node is contracted its list is frozen and nobody else's refers to it.
+class Contractor {
+public:
+    struct DynArc {
+        int node;
+        int weight;
+        int via;
+    };
+
+    Contractor(const IGraph& graph, int witnessLimit)
+        : n(graph.nodeCount()), arcs(n), outCount(n, 0), level(n, 0), deletedNeighbors(n, 0),
+          m_witnessLimit(witnessLimit), m_target(n, 0) {
+        std::vector<Edge> edges;
+        for (int u = 0; u < n; ++u) {
+            graph.getNeighbors(Node{ u }, edges);
+            for (const Edge& e : edges) {
+                if (e.target.id != u) addArc(u, e.target.id, e.weight, -1);
+            }
+        }
+    }
+
+    // Keeps the cheaper of parallel arcs
+    void addArc(int from, int to, int weight, int via) {
+        if (upsert(arcs[from], 0, outCount[from], to, weight, via)) outCount[from]++;
+        upsert(arcs[to], outCount[to], (int)arcs[to].size(), from, weight, via);
+    }
+
+    // Calls emit(u, w, weight) for every shortcut u -> w that contracting v needs.
+    // limit bounds each witness search (settled nodes).
+    template <typename F>
+    int forEachShortcut(int v, int limit, F&& emit) {
+        const DynArc* out = arcs[v].data();
+        const DynArc* outEnd = out + outCount[v];
+        const DynArc* inEnd = arcs[v].data() + arcs[v].size();
+        int maxOut = -1;
+        for (const DynArc* a = out; a != outEnd; ++a) maxOut = std::max(maxOut, a->weight);
+        if (maxOut < 0) return 0;
+        int count = 0;
+        for (const DynArc* in = outEnd; in != inEnd; ++in) {
+            m_targetStamp++;
+            int targets = 0;
+            for (const DynArc* a = out; a != outEnd; ++a) {
+                if (a->node == in->node) continue;
+                m_target[a->node] = m_targetStamp;
+                ++targets;
+            }
+            if (targets == 0) continue;
+            witnessSearch(in->node, v, in->weight + maxOut, targets, limit);
+            for (const DynArc* a = out; a != outEnd; ++a) {
+                if (a->node == in->node) continue;
+                int through = in->weight + a->weight;
+                if (m_ws.dist(a->node) <= through) continue;
+                emit(in->node, a->node, through);
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    // Lower contracts first: shortcuts added minus arcs removed, spread over the
+    // graph by the contracted-neighbour count and depth. Estimated with shorter
+    // witness searches than the contraction itself.
+    int priority(int v) {
+        int added = forEachShortcut(v, std::max(1, m_witnessLimit / 4), [](int, int, int) {});
+        return 4 * (added - (int)arcs[v].size()) + 2 * deletedNeighbors[v] + level[v];
+    }
+
+    int contract(int v) {
+        m_shortcuts.clear();
+        forEachShortcut(v, m_witnessLimit, [&](int u, int w, int weight) { m_shortcuts.push_back({ u, w, weight }); });
+        for (const auto& s : m_shortcuts) addArc(s.from, s.to, s.weight, v);
+        for (const DynArc& a : arcs[v]) {
+            auto& list = arcs[a.node];
+            auto split = list.begin() + outCount[a.node];
+            auto outEnd = std::remove_if(list.begin(), split, [&](const DynArc& b) { return b.node == v; });
+            auto inEnd = std::remove_if(split, list.end(), [&](const DynArc& b) { return b.node == v; });
+            outCount[a.node] = (int)(outEnd - list.begin());
+            list.erase(std::move(split, inEnd, outEnd), list.end());
+            deletedNeighbors[a.node]++;
+            level[a.node] = std::max(level[a.node], level[v] + 1);
+        }
+        return (int)m_shortcuts.size();
+    }
+
+    const int n;
+    std::vector<std::vector<DynArc>> arcs; // Out-arcs [0, outCount), then in-arcs
+    std::vector<int> outCount;
+    std::vector<int> level;
+    std::vector<int> deletedNeighbors;
+
+private:
+    // Updates the arc to node within list[begin, end), or inserts one at end. True if inserted.
+    static bool upsert(std::vector<DynArc>& list, int begin, int end, int node, int weight, int via) {
+        for (int i = begin; i < end; ++i) {
+            DynArc& a = list[i];
+            if (a.node != node) continue;
+            if (weight < a.weight) {
+                a.weight = weight;
+                a.via = via;
+            }
+            return false;
+        }
+        list.insert(list.begin() + end, DynArc{ node, weight, via });
+        return true;
+    }
+
+    // Bounded Dijkstra from source among the remaining nodes, avoiding skip, until
+    // every node marked in m_target is settled. Leaves distances (upper bounds past
+    // the limits) in m_ws.
+    void witnessSearch(int source, int skip, int maxDist, int targets, int limit) {
+        m_ws.reset(n);
+        m_pq.reset(n);
+        m_ws.set(source, 0, -1);
+        m_pq.push(Node{ source }, 0);
+        int settled = 0;
+        while (!m_pq.empty()) {
+            auto [d, curr] = m_pq.pop();
+            if (d != m_ws.dist(curr.id)) continue;
+            if (d > maxDist || ++settled > limit) break;
+            if (m_target[curr.id] == m_targetStamp && --targets == 0) break;
+            const DynArc* a = arcs[curr.id].data();
+            const DynArc* end = a + outCount[curr.id];
+            for (; a != end; ++a) {
+                if (a->node == skip) continue;
+                int nd = d + a->weight;
+                if (nd < m_ws.dist(a->node)) {
+                    m_ws.set(a->node, nd, curr.id);
+                    m_pq.push(Node{ a->node }, nd);
+                }
+            }
+        }
+    }
+
+    struct Shortcut {
+        int from, to, weight;
+    };
+
+    int m_witnessLimit;
+    std::vector<unsigned> m_target; // == m_targetStamp: out-neighbour of the node being contracted
+    unsigned m_targetStamp = 0;
+    SearchWorkspace m_ws;
+    BinaryHeapQueue m_pq;
+    std::vector<Shortcut> m_shortcuts;
+};
+
+// Binary layout, little-endian, all sections 8-byte aligned:
+//   HierarchyHeader (32 bytes)
+//   upFirst:   nodeCount + 1 uint32 offsets into the up arcs
+//   up arcs:   upCount (node, weight, via) int32 triples
+//   downFirst, down arcs: the same for the down side
+struct HierarchyHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    int32_t nodeCount;
+    uint32_t upCount;
+    uint32_t downCount;
+    uint32_t reserved;
+    uint64_t graphHash;
+};
+static_assert(sizeof(HierarchyHeader) == 32, "HierarchyHeader must stay packed");
+
+const char HIERARCHY_MAGIC[4] = { 'C', 'H', 'G', 'R' };
+const uint16_t HIERARCHY_VERSION = 1;
+
+size_t padded(size_t bytes) { return (bytes + 7) & ~size_t(7); }
+
+} // namespace
+
+ContractionHierarchy::BuildStats ContractionHierarchy::build(const IGraph& graph, int witnessLimit) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    BuildStats stats;
+    Contractor c(graph, std::max(witnessLimit, 1));
+    const int n = c.n;
+
+    // Lazy updates: contracting a node only changes its neighbours' priorities, so
+    // instead of recomputing them eagerly a popped node is re-queued if its fresh
+    // priority shows it is no longer the least
+    using Item = std::pair<int, int>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> order;
+    for (int v = 0; v < n; ++v) order.push({ c.priority(v), v });
+    while (!order.empty()) {
+        int v = order.top().second;
+        order.pop();
+        int fresh = c.priority(v);
+        if (!order.empty() && fresh > order.top().first) {
+            order.push({ fresh, v });
+            continue;
+        }
+        stats.shortcuts += c.contract(v);
+        stats.maxLevel = std::max(stats.maxLevel, c.level[v]);
+    }
+
+    // The frozen lists are exactly the upward arcs
+    m_upFirst.assign(n + 1, 0);
+    m_downFirst.assign(n + 1, 0);
+    m_up.clear();
+    m_down.clear();
+    for (int v = 0; v < n; ++v) {
+        const auto& list = c.arcs[v];
+        for (int i = 0; i < (int)list.size(); ++i) {
+            if (i < c.outCount[v]) m_up.push_back({ list[i].node, list[i].weight, list[i].via });
+            else m_down.push_back({ list[i].node, list[i].weight, list[i].via });
+        }
+        m_upFirst[v + 1] = (uint32_t)m_up.size();
+        m_downFirst[v + 1] = (uint32_t)m_down.size();
+        std::vector<Contractor::DynArc>().swap(c.arcs[v]);
+    }
+    m_graphHash = hashGraph(graph);
+
+    stats.timeMs = elapsedMs(startTime);
+    return stats;
+}
+
+bool ContractionHierarchy::matches(const IGraph& graph) const {
+    return !empty() && graph.nodeCount() == nodeCount() && hashGraph(graph) == m_graphHash;
+}
+
+const ContractionHierarchy::Arc* ContractionHierarchy::findUp(int from, int to) const {
+    for (uint32_t i = m_upFirst[from]; i < m_upFirst[from + 1]; ++i) {
+        if (m_up[i].node == to) return &m_up[i];
+    }
+    return nullptr;
+}
+
+const ContractionHierarchy::Arc* ContractionHierarchy::findDown(int to, int from) const {
+    for (uint32_t i = m_downFirst[to]; i < m_downFirst[to + 1]; ++i) {
+        if (m_down[i].node == from) return &m_down[i];
+    }
+    return nullptr;
+}
+
+// A shortcut from -> to via m stands for from -> m (in m's down arcs, from being
+// higher) followed by m -> to (in m's up arcs); both may be shortcuts themselves
+void ContractionHierarchy::unpack(int from, int to, int via, std::vector<Node>& path) const {
+    struct Pending {
+        int from, to, via;
+    };
+    std::vector<Pending> stack = { { from, to, via } };
+    while (!stack.empty()) {
+        Pending p = stack.back();
+        stack.pop_back();
+        if (p.via < 0) {
+            path.push_back(Node{ p.to });
+            continue;
+        }
+        stack.push_back({ p.via, p.to, viaOf(findUp(p.via, p.to)) });
+        stack.push_back({ p.from, p.via, viaOf(findDown(p.via, p.from)) });
+    }
+}
+
+AlgoResult ContractionHierarchy::query(Node start, Node end) const {
+    Workspace workspace;
+    return query(start, end, workspace);
+}
+
+AlgoResult ContractionHierarchy::query(Node start, Node end, Workspace& workspace) const {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    AlgoResult res = { {}, 0, 0, 0, false };
+    const int n = nodeCount();
+    if (start.id < 0 || start.id >= n || end.id < 0 || end.id >= n) {
+        res.timeMs = elapsedMs(startTime);
+        return res;
+    }
+
+    SearchWorkspace& fwd = workspace.forward;
+    SearchWorkspace& bwd = workspace.backward;
+    BinaryHeapQueue& qf = workspace.forwardQueue;
+    BinaryHeapQueue& qb = workspace.backwardQueue;
+    fwd.reset(n); // bwd.parent points one step closer to end
+    bwd.reset(n);
+    qf.reset(n);
+    qb.reset(n);
+    fwd.set(start.id, 0, -1);
+    qf.push(start, 0);
+    bwd.set(end.id, 0, -1);
+    qb.push(end, 0);
+
+    int best = SearchWorkspace::INF;
+    int meet = -1;
+    while (true) {
+        // A side is done once its next key cannot improve on the best meeting
+        bool f = !qf.empty() && qf.topKey() < best;
+        bool b = !qb.empty() && qb.topKey() < best;
+        if (!f && !b) break;
+        bool forward = f && (!b || qf.topKey() <= qb.topKey());
+        SearchWorkspace& self = forward ? fwd : bwd;
+        const SearchWorkspace& other = forward ? bwd : fwd;
+        auto [d, curr] = (forward ? qf : qb).pop();
+        if (d != self.dist(curr.id)) continue; // Stale duplicate
+        res.visitedCount++;
+
+        int v = curr.id;
+        if (other.reached(curr) && d + other.dist(v) < best) {
+            best = d + other.dist(v);
+            meet = v;
+        }
+
+        // Stall-on-demand: an arc from a higher node proves v is reached shorter from above
+        const std::vector<uint32_t>& stallFirst = forward ? m_downFirst : m_upFirst;
+        const std::vector<Arc>& stallArcs = forward ? m_down : m_up;
+        bool stalled = false;
+        for (uint32_t i = stallFirst[v]; i < stallFirst[v + 1] && !stalled; ++i) {
+            int x = stallArcs[i].node;
+            stalled = self.reached(Node{ x }) && self.dist(x) + stallArcs[i].weight < d;
+        }
+        if (stalled) continue;
+
+        const std::vector<uint32_t>& first = forward ? m_upFirst : m_downFirst;
+        const std::vector<Arc>& arcs = forward ? m_up : m_down;
+        BinaryHeapQueue& q = forward ? qf : qb;
+        for (uint32_t i = first[v]; i < first[v + 1]; ++i) {
+            const Arc& a = arcs[i];
+            int nd = d + a.weight;
+            if (nd < self.dist(a.node)) {
+                self.set(a.node, nd, v);
+                q.push(Node{ a.node }, nd);
+            }
+        }
+    }
+
+    if (meet != -1) {
+        res.success = true;
+        res.totalCost = best;
+        std::vector<int> up; // meet back to start
+        for (int v = meet; v != -1; v = fwd.parent(v)) up.push_back(v);
+        res.path.push_back(start);
+        for (size_t i = up.size() - 1; i > 0; --i) unpack(up[i], up[i - 1], viaOf(findUp(up[i], up[i - 1])), res.path);
+        for (int v = meet; bwd.parent(v) != -1; v = bwd.parent(v)) {
+            int next = bwd.parent(v);
+            unpack(v, next, viaOf(findDown(next, v)), res.path);
+        }
+    }
+
+    res.timeMs = elapsedMs(startTime);
+    return res;
+}
+
+std::string ContractionHierarchy::serialize() const {
+    HierarchyHeader header = {};
+    std::memcpy(header.magic, HIERARCHY_MAGIC, 4);
+    header.version = HIERARCHY_VERSION;
+    header.nodeCount = nodeCount();
+    header.upCount = (uint32_t)m_up.size();
+    header.downCount = (uint32_t)m_down.size();
+    header.graphHash = m_graphHash;
+
+    size_t firstSize = padded((size_t)(header.nodeCount + 1) * sizeof(uint32_t));
+    size_t upSize = padded(m_up.size() * sizeof(Arc));
+    size_t downSize = padded(m_down.size() * sizeof(Arc));
+    std::string out(sizeof(header) + 2 * firstSize + upSize + downSize, '\0');
+    char* p = &out[0];
+    std::memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    if (!empty()) {
+        // An arc-free side (e.g. an all-wall map) has a null data(), which memcpy rejects
+        std::memcpy(p, m_upFirst.data(), m_upFirst.size() * sizeof(uint32_t));
+        if (!m_up.empty()) std::memcpy(p + firstSize, m_up.data(), m_up.size() * sizeof(Arc));
+        p += firstSize + upSize;
+        std::memcpy(p, m_downFirst.data(), m_downFirst.size() * sizeof(uint32_t));
+        if (!m_down.empty()) std::memcpy(p + firstSize, m_down.data(), m_down.size() * sizeof(Arc));
+    }
+    return out;
+}
+
+bool ContractionHierarchy::load(const char* data, size_t size, std::string* error) {
+    auto fail = [&](const char* message) {
+        if (error) *error = message;
+        return false;
+    };
+    static_assert(sizeof(Arc) == 12, "Arc is stored as three int32");
+    if (size < sizeof(HierarchyHeader) || std::memcmp(data, HIERARCHY_MAGIC, 4) != 0) return fail("not a contraction hierarchy");
+    HierarchyHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version != HIERARCHY_VERSION) return fail("unsupported hierarchy version");
+    if (header.nodeCount < 0) return fail("negative node count");
+    const int n = header.nodeCount;
+    size_t firstSize = padded((size_t)(n + 1) * sizeof(uint32_t));
+    size_t upSize = padded((size_t)header.upCount * sizeof(Arc));
+    size_t downSize = padded((size_t)header.downCount * sizeof(Arc));
+    if (size - sizeof(header) < 2 * firstSize + upSize + downSize) return fail("hierarchy is truncated");
+
+    std::vector<uint32_t> upFirst(n + 1), downFirst(n + 1);
+    std::vector<Arc> up(header.upCount), down(header.downCount);
+    const char* p = data + sizeof(header);
+    std::memcpy(upFirst.data(), p, upFirst.size() * sizeof(uint32_t));
+    if (!up.empty()) std::memcpy(up.data(), p + firstSize, up.size() * sizeof(Arc));
+    p += firstSize + upSize;
+    std::memcpy(downFirst.data(), p, downFirst.size() * sizeof(uint32_t));
+    if (!down.empty()) std::memcpy(down.data(), p + firstSize, down.size() * sizeof(Arc));
+
+    // Everything a query or unpack indexes must be in range
+    auto validSide = [&](const std::vector<uint32_t>& first, const std::vector<Arc>& arcs) {
+        if (first[0] != 0 || first[n] != arcs.size()) return false;
+        for (int v = 0; v < n; ++v) {
+            if (first[v] > first[v + 1]) return false;
+        }
+        for (const Arc& a : arcs) {
+            if (a.node < 0 || a.node >= n || a.weight < 0 || a.via < -1 || a.via >= n) return false;
+        }
+        return true;
+    };
+    if (!validSide(upFirst, up)) return fail("up arcs are malformed");
+    if (!validSide(downFirst, down)) return fail("down arcs are malformed");
+
+    m_upFirst = std::move(upFirst);
+    m_downFirst = std::move(downFirst);
+    m_up = std::move(up);
+    m_down = std::move(down);
+    m_graphHash = header.graphHash;
+    if (n == 0) {
+        m_upFirst.clear();
+        m_downFirst.clear();
+    }
+    return true;
+}
+
+bool ContractionHierarchy::saveFile(const FilePath& path) const {
+    std::string bytes = serialize();
+    std::ofstream out(path.c_str(), std::ios::binary);
+    out.write(bytes.data(), (std::streamsize)bytes.size());
+    return (bool)out;
+}
+
+bool ContractionHierarchy::openFile(const FilePath& path, std::string* error) {
+    MappedFile file(path, false);
+    if (!file.data()) {
+        if (error) *error = "cannot open or map the file";
+        return false;
+    }
+    return load(file.data(), file.size(), error);
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "Algorithms.h"
+#include "MappedFile.h"
+#include "SearchWorkspace.h"
+#include "PriorityQueues.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Contraction Hierarchy over a static IGraph: preprocess once, then answer
+// point-to-point queries by searching only "upward" from both ends.
+//
+// build() contracts the nodes one by one, least important first (edge
+// difference + contracted neighbours + depth, updated lazily). Removing a node
+// v adds a shortcut u -> w for each pair of its remaining neighbours unless a
+// bounded witness search finds a path from u to w that avoids v and is no
+// longer. Every node keeps the arcs it had to still-uncontracted (higher
+// ranked) nodes at the time it was contracted: its upward out-arcs for the
+// forward search, and its in-arcs from higher nodes for the backward one.
+//
+// query() is a bidirectional Dijkstra over those arcs, with stall-on-demand.
+// totalCost equals runDijkstra's. The path is unpacked back to original edges,
+// so it may differ from runDijkstra's among equally short ones. visitedCount
+// counts the nodes settled by both halves.
+//
+// Edits to the graph invalidate the hierarchy: rebuild (matches() tells a stale
+// one apart). Edge weights must be non-negative.
+class ContractionHierarchy {
+public:
+    // Per-query search state, reset in O(1) (see SearchWorkspace). One per thread.
+    struct Workspace {
+        SearchWorkspace forward, backward;
+        BinaryHeapQueue forwardQueue, backwardQueue;
+    };
+
+    struct BuildStats {
+        int shortcuts = 0;
+        int maxLevel = 0; // Depth of the deepest contracted node
+        double timeMs = 0;
+    };
+
+    // Replaces any previous hierarchy. witnessLimit bounds the nodes settled by
+    // each witness search: lower builds faster but adds more shortcuts.
+    BuildStats build(const IGraph& graph, int witnessLimit = 256);
+
+    bool empty() const { return m_upFirst.empty(); }
+    int nodeCount() const { return empty() ? 0 : (int)m_upFirst.size() - 1; }
+    size_t arcCount() const { return m_up.size() + m_down.size(); }
+
+    // Whether this hierarchy was built from a graph with exactly graph's edges
+    bool matches(const IGraph& graph) const;
+
+    AlgoResult query(Node start, Node end, Workspace& workspace) const;
+    AlgoResult query(Node start, Node end) const; // Allocates a workspace per call
+
+    // Versioned binary format (see ContractionHierarchy.cpp): header, then the
+    // two arc arrays in CSR form. load() leaves the hierarchy untouched on failure.
+    std::string serialize() const;
+    bool load(const char* data, size_t size, std::string* error = nullptr);
+    // The same format in a native file; openFile maps it instead of reading it
+    // into a buffer (not used by the Wasm build)
+    bool saveFile(const FilePath& path) const;
+    bool openFile(const FilePath& path, std::string* error = nullptr);
+
+private:
+    // via is the contracted node a shortcut bypasses, -1 for an original edge
+    struct Arc {
+        int node;
+        int weight;
+        int via;
+    };
+
+    // Appends the original nodes strictly after from on the arc from -> to
+    void unpack(int from, int to, int via, std::vector<Node>& path) const;
+    const Arc* findUp(int from, int to) const;   // from's arc to higher node to
+    const Arc* findDown(int to, int from) const; // to's arc from higher node from
+    // A missing arc (only in a corrupt file) unpacks as a plain edge
+    static int viaOf(const Arc* arc) { return arc ? arc->via : -1; }
+
+    // m_up[m_upFirst[v] .. m_upFirst[v + 1]): arcs v -> node with node ranked above v.
+    // m_down likewise: arcs node -> v with node ranked above v.
+    std::vector<uint32_t> m_upFirst, m_downFirst;
+    std::vector<Arc> m_up, m_down;
+    uint64_t m_graphHash = 0;
+};
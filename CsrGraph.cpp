@@ -0,0 +1,378 @@
+#include "CsrGraph.h"
+#include "SearchKernels.h"
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace {
+
+bool fail(GraphLoadError* error, size_t offset, std::string message) {
+    if (error) *error = { offset, std::move(message) };
+    return false;
+}
+
+// Walks a text line by line and reads blank-separated fields from the current line.
+// Numbers go through std::from_chars (no locale, no allocation).
+class LineReader {
+public:
+    // base is added to every reported offset, for a text that starts inside a larger one
+    explicit LineReader(std::string_view text, size_t base = 0) : m_text(text), m_base(base) {}
+
+    bool next() {
+        if (m_next >= m_text.size()) return false;
+        m_start = m_next;
+        const void* newline = std::memchr(m_text.data() + m_start, '\n', m_text.size() - m_start);
+        size_t end = newline ? (const char*)newline - m_text.data() : m_text.size();
+        m_line = m_text.substr(m_start, end - m_start);
+        m_pos = 0;
+        m_next = end + 1;
+        return true;
+    }
+
+    // First character of the line after leading blanks, 0 if there is none
+    char kind() {
+        skipBlanks();
+        return m_pos < m_line.size() ? m_line[m_pos] : 0;
+    }
+    // Consumes one field if it equals word
+    bool word(std::string_view word) {
+        skipBlanks();
+        size_t end = m_pos;
+        while (end < m_line.size() && !isBlank(m_line[end])) ++end;
+        if (m_line.substr(m_pos, end - m_pos) != word) return false;
+        m_pos = end;
+        return true;
+    }
+    bool integer(int64_t& value) {
+        skipBlanks();
+        const char* begin = m_line.data() + m_pos;
+        auto res = std::from_chars(begin, m_line.data() + m_line.size(), value);
+        if (res.ec != std::errc() || res.ptr == begin) return false;
+        m_pos = res.ptr - m_line.data();
+        return m_pos == m_line.size() || isBlank(m_line[m_pos]);
+    }
+    bool done() {
+        skipBlanks();
+        return m_pos == m_line.size();
+    }
+    size_t offset() const { return m_base + m_start + m_pos; }
+    size_t lineStart() const { return m_base + m_start; }
+    size_t lineEnd() const { return m_base + std::min(m_next, m_text.size()); } // Just past the newline
+
+private:
+    static bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+    void skipBlanks() { while (m_pos < m_line.size() && isBlank(m_line[m_pos])) ++m_pos; }
+
+    std::string_view m_text, m_line;
+    size_t m_base;
+    size_t m_start = 0, m_next = 0, m_pos = 0;
+};
+
+// Fixed-size prefix of the cache file, followed by the block
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    int32_t nodes;
+    int32_t edges;
+    double scale;
+};
+constexpr char CACHE_MAGIC[8] = { 'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H' };
+constexpr uint32_t CACHE_VERSION = 1;
+constexpr uint32_t HAS_COORDINATES = 1;
+
+} // namespace
+
+void CsrGraph::bind(const int32_t* block, int nodes, int edges, bool coordinates) {
+    m_nodes = nodes;
+    m_edges = edges;
+    m_offsets = block;
+    m_targets = m_offsets + nodes + 1;
+    m_weights = m_targets + edges;
+    m_revOffsets = m_weights + edges;
+    m_sources = m_revOffsets + nodes + 1;
+    m_revWeights = m_sources + edges;
+    m_x = coordinates ? m_revWeights + edges : nullptr;
+    m_y = coordinates ? m_x + nodes : nullptr;
+}
+
+void CsrGraph::adopt(std::vector<int32_t>&& block, int nodes, int edges) {
+    m_block = std::move(block);
+    m_mapping.reset();
+    m_scale = 0;
+    bind(m_block.data(), nodes, edges, false);
+}
+
+// Two passes over the arcs: the first counts degrees (and finds the node count when
+// nodes < 0), the second writes each arc straight into its slot. No edge list is
+// materialized, so peak memory is the block plus two per-node cursors.
+template <typename ForEachArc>
+bool CsrGraph::assemble(ForEachArc&& forEachArc, int nodes, GraphLoadError* error) {
+    std::vector<int32_t> outCursor(std::max(nodes, 0), 0), inCursor(std::max(nodes, 0), 0);
+    int64_t edges = 0;
+    bool counted = forEachArc([&](int u, int v, int) {
+        if (nodes < 0 && std::max(u, v) >= (int)outCursor.size()) {
+            outCursor.resize(std::max(u, v) + 1, 0);
+            inCursor.resize(outCursor.size(), 0);
+        }
+        outCursor[u]++;
+        inCursor[v]++;
+        edges++;
+    });
+    if (!counted) return false;
+    if (edges > INT32_MAX) return fail(error, 0, "more than 2^31 - 1 arcs");
+    const int n = (int)outCursor.size(), m = (int)edges;
+
+    std::vector<int32_t> block(blockSize(n, m, false));
+    int32_t* offsets = block.data();
+    int32_t* targets = offsets + n + 1;
+    int32_t* weights = targets + m;
+    int32_t* revOffsets = weights + m;
+    int32_t* sources = revOffsets + n + 1;
+    int32_t* revWeights = sources + m;
+    for (int v = 0; v < n; ++v) {
+        offsets[v + 1] = offsets[v] + outCursor[v];
+        revOffsets[v + 1] = revOffsets[v] + inCursor[v];
+        outCursor[v] = offsets[v];
+        inCursor[v] = revOffsets[v];
+    }
+    forEachArc([&](int u, int v, int w) {
+        int e = outCursor[u]++;
+        targets[e] = v;
+        weights[e] = w;
+        int r = inCursor[v]++;
+        sources[r] = u;
+        revWeights[r] = w;
+    });
+    adopt(std::move(block), n, m);
+    return true;
+}
+
+bool CsrGraph::loadDimacs(std::string_view gr, GraphLoadError* error) {
+    // The problem line comes first and fixes n and m for both passes
+    LineReader header(gr);
+    int64_t n = -1, m = -1;
+    while (header.next()) {
+        char c = header.kind();
+        if (c == 0 || c == 'c') continue;
+        if (!header.word("p") || !header.word("sp")) return fail(error, header.lineStart(), "expected \"p sp <nodes> <arcs>\"");
+        if (!header.integer(n) || n < 0 || n >= INT32_MAX) return fail(error, header.offset(), "bad node count");
+        if (!header.integer(m) || m < 0 || m > INT32_MAX) return fail(error, header.offset(), "bad arc count");
+        break;
+    }
+    if (n < 0) return fail(error, gr.size(), "missing problem line");
+    const size_t body = header.lineEnd();
+
+    auto arcs = [&](auto&& arc) {
+        LineReader lines(gr.substr(body), body);
+        int64_t count = 0;
+        while (lines.next()) {
+            char c = lines.kind();
+            if (c == 0 || c == 'c') continue;
+            int64_t u, v, w;
+            if (!lines.word("a")) return fail(error, lines.lineStart(), "expected \"a <from> <to> <weight>\"");
+            if (!lines.integer(u) || u < 1 || u > n) return fail(error, lines.offset(), "bad source node");
+            if (!lines.integer(v) || v < 1 || v > n) return fail(error, lines.offset(), "bad target node");
+            if (!lines.integer(w) || w < 0 || w > INT32_MAX) return fail(error, lines.offset(), "bad weight");
+            if (!lines.done()) return fail(error, lines.offset(), "unexpected text after the arc");
+            if (++count > m) return fail(error, lines.lineStart(), "more arcs than the problem line declares");
+            arc((int)u - 1, (int)v - 1, (int)w);
+        }
+        if (count != m) return fail(error, gr.size(), "fewer arcs than the problem line declares");
+        return true;
+    };
+    return assemble(arcs, (int)n, error);
+}
+
+bool CsrGraph::loadEdgeList(std::string_view text, bool undirected, GraphLoadError* error) {
+    auto arcs = [&](auto&& arc) {
+        LineReader lines(text);
+        while (lines.next()) {
+            char c = lines.kind();
+            if (c == 0 || c == '#' || c == '%') continue;
+            int64_t u, v, w = 1;
+            if (!lines.integer(u) || u < 0 || u >= INT32_MAX - 1) return fail(error, lines.offset(), "bad source node");
+            if (!lines.integer(v) || v < 0 || v >= INT32_MAX - 1) return fail(error, lines.offset(), "bad target node");
+            if (!lines.done() && (!lines.integer(w) || w < 0 || w > INT32_MAX)) return fail(error, lines.offset(), "bad weight");
+            if (!lines.done()) return fail(error, lines.offset(), "unexpected text after the edge");
+            arc((int)u, (int)v, (int)w);
+            if (undirected) arc((int)v, (int)u, (int)w);
+        }
+        return true;
+    };
+    return assemble(arcs, -1, error);
+}
+
+void CsrGraph::build(const IGraph& graph) {
+    const int n = graph.nodeCount();
+    auto arcs = [&](auto&& arc) {
+        std::vector<Edge> edges;
+        for (int v = 0; v < n; ++v) {
+            graph.getNeighbors(Node{ v }, edges);
+            for (const Edge& e : edges) arc(v, e.target.id, e.weight);
+        }
+        return true;
+    };
+    assemble(arcs, n, nullptr);
+}
+
+bool CsrGraph::loadCoordinates(std::string_view co, GraphLoadError* error) {
+    LineReader lines(co);
+    int64_t n = -1;
+    std::vector<int32_t> x, y;
+    std::vector<char> seen;
+    int64_t count = 0;
+    while (lines.next()) {
+        char c = lines.kind();
+        if (c == 0 || c == 'c') continue;
+        if (n < 0) {
+            if (!lines.word("p") || !lines.word("aux") || !lines.word("sp") || !lines.word("co"))
+                return fail(error, lines.lineStart(), "expected \"p aux sp co <nodes>\"");
+            if (!lines.integer(n) || n != m_nodes) return fail(error, lines.offset(), "node count differs from the graph's");
+            x.assign(n, 0);
+            y.assign(n, 0);
+            seen.assign(n, 0);
+            continue;
+        }
+        int64_t id, px, py;
+        if (!lines.word("v")) return fail(error, lines.lineStart(), "expected \"v <node> <x> <y>\"");
+        if (!lines.integer(id) || id < 1 || id > n) return fail(error, lines.offset(), "bad node");
+        if (!lines.integer(px) || px < INT32_MIN || px > INT32_MAX) return fail(error, lines.offset(), "bad x coordinate");
+        if (!lines.integer(py) || py < INT32_MIN || py > INT32_MAX) return fail(error, lines.offset(), "bad y coordinate");
+        if (seen[id - 1]) return fail(error, lines.lineStart(), "node listed twice");
+        seen[id - 1] = 1;
+        x[id - 1] = (int32_t)px;
+        y[id - 1] = (int32_t)py;
+        count++;
+    }
+    if (n < 0) return fail(error, co.size(), "missing problem line");
+    if (count != n) return fail(error, co.size(), "some nodes have no coordinates");
+    return setCoordinates(x, y);
+}
+
+bool CsrGraph::setCoordinates(const std::vector<int32_t>& x, const std::vector<int32_t>& y) {
+    if ((int)x.size() != m_nodes || (int)y.size() != m_nodes) return false;
+    const size_t base = blockSize(m_nodes, m_edges, false);
+    if (m_mapping) { // Copy out of the cache: the mapping is read-only
+        m_block.assign(m_offsets, m_offsets + base);
+        m_mapping.reset();
+    }
+    m_block.resize(base + 2 * (size_t)m_nodes);
+    std::copy(x.begin(), x.end(), m_block.begin() + base);
+    std::copy(y.begin(), y.end(), m_block.begin() + base + m_nodes);
+    bind(m_block.data(), m_nodes, m_edges, true);
+    computeScale();
+    return true;
+}
+
+// Largest c with c * length(u, v) <= w(u, v) on every arc. By the triangle inequality
+// c * |p - t| then never exceeds the cost of any path from p to t.
+void CsrGraph::computeScale() {
+    double scale = std::numeric_limits<double>::infinity();
+    for (int u = 0; u < m_nodes; ++u) {
+        for (int32_t e = m_offsets[u]; e < m_offsets[u + 1]; ++e) {
+            int v = m_targets[e];
+            double dx = (double)m_x[u] - m_x[v], dy = (double)m_y[u] - m_y[v];
+            double length = std::sqrt(dx * dx + dy * dy);
+            if (length > 0) scale = std::min(scale, m_weights[e] / length);
+        }
+    }
+    m_scale = std::isinf(scale) ? 0 : scale;
+}
+
+bool CsrGraph::loadDimacsFile(const FilePath& gr, const FilePath& co, GraphLoadError* error) {
+    {
+        MappedFile file(gr);
+        if (!file.data()) return fail(error, 0, "cannot open or map the graph file");
+        if (!loadDimacs(std::string_view(file.data(), file.size()), error)) return false;
+    }
+    if (co.empty()) return true;
+    MappedFile file(co);
+    if (!file.data()) return fail(error, 0, "cannot open or map the coordinate file");
+    return loadCoordinates(std::string_view(file.data(), file.size()), error);
+}
+
+bool CsrGraph::loadEdgeListFile(const FilePath& path, bool undirected, GraphLoadError* error) {
+    MappedFile file(path);
+    if (!file.data()) return fail(error, 0, "cannot open or map the file");
+    return loadEdgeList(std::string_view(file.data(), file.size()), undirected, error);
+}
+
+bool CsrGraph::saveCache(const FilePath& path) const {
+    CacheHeader header = {};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.flags = hasCoordinates() ? HAS_COORDINATES : 0;
+    header.nodes = m_nodes;
+    header.edges = m_edges;
+    header.scale = m_scale;
+    std::ofstream out(path.c_str(), std::ios::binary);
+    out.write((const char*)&header, sizeof(header));
+    if (m_offsets) out.write((const char*)m_offsets, memoryBytes());
+    else out.write("\0\0\0\0\0\0\0\0", 8); // Empty graph: offsets[0] and revOffsets[0]
+    return (bool)out;
+}
+
+// Checks only what is O(n): the header, the file size and the offset arrays' ends.
+// The arcs themselves are trusted, as the file was written by saveCache.
+bool CsrGraph::openCache(const FilePath& path, GraphLoadError* error) {
+    auto file = std::make_shared<MappedFile>(path, false);
+    if (!file->data()) return fail(error, 0, "cannot open or map the file");
+    CacheHeader header;
+    if (file->size() < sizeof(header)) return fail(error, 0, "file too short for a cache header");
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0) return fail(error, 0, "not a graph cache");
+    if (header.version != CACHE_VERSION) return fail(error, offsetof(CacheHeader, version), "unsupported cache version");
+    if (header.nodes < 0 || header.edges < 0) return fail(error, offsetof(CacheHeader, nodes), "bad node or arc count");
+    const bool coordinates = header.flags & HAS_COORDINATES;
+    if (file->size() != sizeof(header) + blockSize(header.nodes, header.edges, coordinates) * sizeof(int32_t))
+        return fail(error, sizeof(header), "file size does not match the header");
+
+    const int32_t* block = (const int32_t*)(file->data() + sizeof(header));
+    const int32_t* revOffsets = block + 2 * (size_t)header.edges + header.nodes + 1;
+    if (block[0] != 0 || block[header.nodes] != header.edges || revOffsets[0] != 0 || revOffsets[header.nodes] != header.edges)
+        return fail(error, sizeof(header), "offset arrays do not match the arc count");
+
+    m_block.clear();
+    m_block.shrink_to_fit();
+    m_mapping = std::move(file);
+    bind(block, header.nodes, header.edges, coordinates);
+    m_scale = header.scale;
+    return true;
+}
+
+AlgoResult runDijkstra(const CsrGraph& graph, Node start, Node end, IAlgorithmObserver* observer, QueueKind queue) {
+    return dispatchQueue(queue, [&](auto tag) {
+        using Q = typename decltype(tag)::type;
+        return dispatchView(graph, observer, [&](const auto& view, const auto& sink) { return dijkstraSearch<Q>(view, start, end, sink); });
+    });
+}
+
+AlgoResult runBFS(const CsrGraph& graph, Node start, Node end, IAlgorithmObserver* observer) {
+    return dispatchView(graph, observer, [&](const auto& view, const auto& sink) { return bfsSearch(view, start, end, sink); });
+}
+
+AlgoResult runAStar(const CsrGraph& graph, Node start, Node end, IAlgorithmObserver* observer, QueueKind queue) {
+    return dispatchQueue(queue, [&](auto tag) {
+        using Q = typename decltype(tag)::type;
+        return dispatchView(graph, observer, [&](const auto& view, const auto& sink) { return aStarSearch<Q>(view, start, end, sink); });
+    });
+}
+
+AlgoResult runBiDijkstra(const CsrGraph& graph, Node start, Node end, IAlgorithmObserver* observer, QueueKind queue) {
+    return dispatchQueue(queue, [&](auto tag) {
+        using Q = typename decltype(tag)::type;
+        return dispatchView(graph, observer, [&](const auto& view, const auto& sink) { return bidirectionalSearch<Q, false>(view, start, end, sink); });
+    });
+}
+
+AlgoResult runBiAStar(const CsrGraph& graph, Node start, Node end, IAlgorithmObserver* observer, QueueKind queue) {
+    return dispatchQueue(queue, [&](auto tag) {
+        using Q = typename decltype(tag)::type;
+        return dispatchView(graph, observer, [&](const auto& view, const auto& sink) { return bidirectionalSearch<Q, true>(view, start, end, sink); });
+    });
+}
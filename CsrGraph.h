@@ -0,0 +1,122 @@
+#pragma once
+#include "Algorithms.h"
+#include "IGraph.h"
+#include "MappedFile.h"
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Why a CsrGraph loader rejected its input. offset is the byte position of the problem.
+struct GraphLoadError {
+    size_t offset = 0;
+    std::string message;
+};
+
+// Compressed sparse row graph for inputs that are not grids (road networks etc.).
+// Out-edges of v are targets/weights[offsets[v] .. offsets[v + 1]); a reverse CSR
+// serves getPredecessors. All arrays are int32 in one contiguous block, laid out
+// exactly as in the cache file, so openCache() maps the file and uses it in place:
+// reopening a 20M-arc graph costs a header check, not a parse.
+//
+// With coordinates (DIMACS .co or setCoordinates) getHeuristic is the Euclidean
+// distance times the largest factor no arc undercuts (min weight / length), which
+// keeps A* admissible whatever units the coordinates and weights are in.
+// Search kernels run on it directly (see the entry points below), without the virtual API.
+class CsrGraph final : public IGraph {
+public:
+    CsrGraph() = default;
+    CsrGraph(CsrGraph&&) = default;
+    CsrGraph& operator=(CsrGraph&&) = default;
+    CsrGraph(const CsrGraph&) = delete; // Arrays point into the owned block
+    CsrGraph& operator=(const CsrGraph&) = delete;
+
+    // DIMACS shortest-path format: "p sp n m", then m lines "a u v w" with 1-based ids.
+    // Loaders replace the whole graph and leave it untouched on failure.
+    bool loadDimacs(std::string_view gr, GraphLoadError* error = nullptr);
+    // DIMACS coordinates, "p aux sp co n" then "v id x y", for the loaded graph
+    bool loadCoordinates(std::string_view co, GraphLoadError* error = nullptr);
+    // One arc per line, "u v [w]" with 0-based ids and weight 1 by default; lines
+    // starting with '#' or '%' are comments. undirected adds every arc both ways.
+    bool loadEdgeList(std::string_view text, bool undirected = false, GraphLoadError* error = nullptr);
+    // Copies any graph's arcs (e.g. a Grid's), without coordinates
+    void build(const IGraph& graph);
+    // One point per node; also recomputes the heuristic factor
+    bool setCoordinates(const std::vector<int32_t>& x, const std::vector<int32_t>& y);
+
+    // Native files, memory-mapped and parsed in place (not used by the Wasm build)
+    bool loadDimacsFile(const FilePath& gr, const FilePath& co = FilePath(), GraphLoadError* error = nullptr);
+    bool loadEdgeListFile(const FilePath& path, bool undirected = false, GraphLoadError* error = nullptr);
+    // Binary cache in native byte order: header, then the block
+    bool saveCache(const FilePath& path) const;
+    bool openCache(const FilePath& path, GraphLoadError* error = nullptr);
+
+    int edgeCount() const { return m_edges; }
+    bool hasCoordinates() const { return m_x != nullptr; }
+    double heuristicScale() const { return m_scale; }
+    bool mapped() const { return m_mapping != nullptr; } // Arrays live in a cache file
+    size_t memoryBytes() const { return blockSize(m_nodes, m_edges, hasCoordinates()) * sizeof(int32_t); }
+
+    // Kernel graph model (see SearchKernels.h)
+    template <typename F>
+    void forEachNeighbor(Node n, F&& visit) const {
+        for (int32_t e = m_offsets[n.id], end = m_offsets[n.id + 1]; e < end; ++e) visit(Node{ m_targets[e] }, m_weights[e]);
+    }
+    template <typename F>
+    void forEachPredecessor(Node n, F&& visit) const {
+        for (int32_t e = m_revOffsets[n.id], end = m_revOffsets[n.id + 1]; e < end; ++e) visit(Node{ m_sources[e] }, m_revWeights[e]);
+    }
+
+    // IGraph Implementation
+    using IGraph::getNeighbors;
+    void getNeighbors(Node n, std::vector<Edge>& out) const override {
+        out.clear();
+        forEachNeighbor(n, [&](Node t, int w) { out.push_back({ t, w }); });
+    }
+    void getPredecessors(Node n, std::vector<Edge>& out) const override {
+        out.clear();
+        forEachPredecessor(n, [&](Node s, int w) { out.push_back({ s, w }); });
+    }
+    int nodeCount() const override { return m_nodes; }
+    int getHeuristic(Node start, Node target) const override {
+        if (!m_x) return 0;
+        double dx = (double)m_x[start.id] - m_x[target.id], dy = (double)m_y[start.id] - m_y[target.id];
+        return (int)(std::sqrt(dx * dx + dy * dy) * m_scale);
+    }
+
+private:
+    // Sections in order: offsets[n + 1], targets[m], weights[m], revOffsets[n + 1],
+    // sources[m], revWeights[m], then x[n], y[n] when there are coordinates
+    static size_t blockSize(int nodes, int edges, bool coordinates) {
+        return 2 * ((size_t)nodes + 1) + 4 * (size_t)edges + (coordinates ? 2 * (size_t)nodes : 0);
+    }
+    void bind(const int32_t* block, int nodes, int edges, bool coordinates);
+    void adopt(std::vector<int32_t>&& block, int nodes, int edges);
+    void computeScale();
+    template <typename ForEachArc>
+    bool assemble(ForEachArc&& forEachArc, int nodes, GraphLoadError* error);
+
+    std::vector<int32_t> m_block; // Empty when mapped
+    std::shared_ptr<const MappedFile> m_mapping;
+    int m_nodes = 0;
+    int m_edges = 0;
+    double m_scale = 0;
+    const int32_t* m_offsets = nullptr;
+    const int32_t* m_targets = nullptr;
+    const int32_t* m_weights = nullptr;
+    const int32_t* m_revOffsets = nullptr;
+    const int32_t* m_sources = nullptr;
+    const int32_t* m_revWeights = nullptr;
+    const int32_t* m_x = nullptr;
+    const int32_t* m_y = nullptr;
+};
+
+// Entry points over a CsrGraph (Algorithms.h has the IGraph ones): the kernels walk
+// the arrays directly. Other engines taking an IGraph use the virtual API on it.
+AlgoResult runDijkstra(const CsrGraph& graph, Node start, Node end, IAlgorithmObserver* observer = nullptr, QueueKind queue = QueueKind::BinaryHeap);
+AlgoResult runBFS(const CsrGraph& graph, Node start, Node end, IAlgorithmObserver* observer = nullptr);
+AlgoResult runAStar(const CsrGraph& graph, Node start, Node end, IAlgorithmObserver* observer = nullptr, QueueKind queue = QueueKind::BinaryHeap);
+AlgoResult runBiDijkstra(const CsrGraph& graph, Node start, Node end, IAlgorithmObserver* observer = nullptr, QueueKind queue = QueueKind::BinaryHeap);
+AlgoResult runBiAStar(const CsrGraph& graph, Node start, Node end, IAlgorithmObserver* observer = nullptr, QueueKind queue = QueueKind::BinaryHeap);
@@ -0,0 +1,232 @@
+#include "DStarLite.h"
+#include "SearchKernels.h"
+#include <functional>
+
+namespace {
+
+constexpr int INF = SearchWorkspace::INF;
+
+int add(int a, int b) {
+    if (a == INF || b == INF) return INF;
+    long long sum = (long long)a + b;
+    return sum >= INF ? INF : (int)sum;
+}
+
+using HeapEntry = std::pair<std::pair<int, int>, int>;
+const auto heapOrder = std::greater<HeapEntry>();
+
+} // namespace
+
+DStarLite::DStarLite(Grid& grid) : m_grid(&grid) {
+    m_grid->addListener(this);
+}
+
+DStarLite::~DStarLite() {
+    if (m_grid) m_grid->removeListener(this);
+}
+
+void DStarLite::onCellChanged(Node cell) {
+    if (m_fresh || cell.id < 0 || cell.id >= (int)m_isEdited.size() || m_isEdited[cell.id]) return;
+    m_isEdited[cell.id] = 1;
+    m_edited.push_back(cell.id);
+}
+
+template <typename F>
+void DStarLite::forEachAdjacent(int v, F&& visit) const {
+    static constexpr int dx[] = {-1, 1, 0, 0, -1, -1, 1, 1};
+    static constexpr int dy[] = {0, 0, -1, 1, -1, 1, -1, 1};
+    static constexpr int cost[] = {10, 10, 10, 10, 14, 14, 14, 14};
+    const int dirs = m_diagonal ? 8 : 4;
+    int x = v / m_width, y = v % m_width;
+    for (int i = 0; i < dirs; ++i) {
+        int nx = x + dx[i], ny = y + dy[i];
+        if (nx >= 0 && nx < m_height && ny >= 0 && ny < m_width) visit(nx * m_width + ny, cost[i]);
+    }
+}
+
+int DStarLite::heuristic(int a, int b) const {
+    return m_diagonal ? m_grid->heuristic<true>(Node{ a }, Node{ b }) : m_grid->heuristic<false>(Node{ a }, Node{ b });
+}
+
+DStarLite::Key DStarLite::key(int v) const {
+    int m = std::min(m_g[v], m_rhs[v]);
+    return { add(add(m, heuristic(m_last, v)), m_km), m };
+}
+
+void DStarLite::updateVertex(int v) {
+    if (m_g[v] == m_rhs[v]) {
+        m_queued[v] = UNQUEUED;
+        return;
+    }
+    Key k = key(v);
+    if (m_queued[v] == k) return;
+    m_queued[v] = k;
+    m_heap.push_back({ k, v });
+    std::push_heap(m_heap.begin(), m_heap.end(), heapOrder);
+}
+
+// Entering a cell costs its step times its weight, as in Grid::forEachNeighbor
+int DStarLite::bestRhs(int v) const {
+    int best = INF;
+    forEachAdjacent(v, [&](int u, int step) {
+        if (m_enter[u]) best = std::min(best, add(step * m_enter[u], m_g[u]));
+    });
+    return best;
+}
+
+void DStarLite::initialize(Node start, Node goal) {
+    const Grid& grid = *m_grid;
+    m_width = grid.getWidth();
+    m_height = grid.getHeight();
+    m_diagonal = grid.getAllowDiagonals();
+    const int n = grid.nodeCount();
+    m_g.assign(n, INF);
+    m_rhs.assign(n, INF);
+    m_queued.assign(n, UNQUEUED);
+    m_enter.resize(n);
+    for (int v = 0; v < n; ++v) m_enter[v] = grid.isObstacle(v / m_width, v % m_width) ? 0 : grid.getWeight(v / m_width, v % m_width);
+    m_heap.clear();
+    m_edited.clear();
+    m_isEdited.assign(n, 0);
+    m_km = 0;
+    m_goal = goal.id;
+    m_last = start.id;
+    m_fresh = false;
+    m_rhs[m_goal] = 0;
+    updateVertex(m_goal);
+}
+
+// A changed cell c only changes the edges into it, u -> c for each cell u around it
+void DStarLite::applyEdits() {
+    const Grid& grid = *m_grid;
+    for (int c : m_edited) {
+        m_isEdited[c] = 0;
+        int now = grid.isObstacle(c / m_width, c % m_width) ? 0 : grid.getWeight(c / m_width, c % m_width);
+        int before = m_enter[c];
+        if (now == before) continue;
+        m_enter[c] = now;
+        forEachAdjacent(c, [&](int u, int step) {
+            if (u == m_goal) return;
+            int oldCost = before ? step * before : INF;
+            int newCost = now ? step * now : INF;
+            if (newCost < oldCost) m_rhs[u] = std::min(m_rhs[u], add(newCost, m_g[c]));
+            else if (m_rhs[u] == add(oldCost, m_g[c])) m_rhs[u] = bestRhs(u);
+            updateVertex(u);
+        });
+    }
+    m_edited.clear();
+
+    // Drop stale entries once they dominate the heap
+    if (m_heap.size() > 2 * m_g.size() + 64) {
+        size_t live = 0;
+        for (const auto& e : m_heap) {
+            if (m_queued[e.second] == e.first) m_heap[live++] = e;
+        }
+        m_heap.resize(live);
+        std::make_heap(m_heap.begin(), m_heap.end(), heapOrder);
+    }
+}
+
+template <typename Sink>
+int DStarLite::computeShortestPath(const Sink& sink) {
+    int expanded = 0;
+    const int start = m_last;
+    while (!m_heap.empty()) {
+        auto [top, u] = m_heap.front();
+        if (m_queued[u] != top) { // Stale
+            std::pop_heap(m_heap.begin(), m_heap.end(), heapOrder);
+            m_heap.pop_back();
+            continue;
+        }
+        if (!(top < key(start)) && m_rhs[start] == m_g[start]) break;
+        std::pop_heap(m_heap.begin(), m_heap.end(), heapOrder);
+        m_heap.pop_back();
+        m_queued[u] = UNQUEUED;
+
+        Key fresh = key(u);
+        if (top < fresh) { // Keys computed before the start moved
+            m_queued[u] = fresh;
+            m_heap.push_back({ fresh, u });
+            std::push_heap(m_heap.begin(), m_heap.end(), heapOrder);
+            continue;
+        }
+        expanded++;
+        sink.visited(Node{ u });
+
+        // Predecessors of u are the cells around it, whenever u can be entered
+        if (m_g[u] > m_rhs[u]) {
+            m_g[u] = m_rhs[u];
+            if (!m_enter[u]) continue;
+            forEachAdjacent(u, [&](int s, int step) {
+                if (s == m_goal) return;
+                m_rhs[s] = std::min(m_rhs[s], add(step * m_enter[u], m_g[u]));
+                updateVertex(s);
+            });
+        } else {
+            int gOld = m_g[u];
+            m_g[u] = INF;
+            if (m_enter[u]) {
+                forEachAdjacent(u, [&](int s, int step) {
+                    if (s != m_goal && m_rhs[s] == add(step * m_enter[u], gOld)) m_rhs[s] = bestRhs(s);
+                    updateVertex(s);
+                });
+            }
+            if (u != m_goal) m_rhs[u] = bestRhs(u);
+            updateVertex(u);
+        }
+    }
+    return expanded;
+}
+
+AlgoResult DStarLite::plan(Node start, Node goal, IAlgorithmObserver* observer) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    AlgoResult res = { {}, 0, 0, 0, false };
+    if (!m_grid) return res;
+    const int n = m_grid->nodeCount();
+    if (start.id < 0 || start.id >= n || goal.id < 0 || goal.id >= n) {
+        res.timeMs = elapsedMs(startTime);
+        return res;
+    }
+
+    ObserverSink sink(observer);
+    if (m_fresh || goal.id != m_goal || (int)m_g.size() != n) {
+        sink.log("D* Lite: planning from scratch...");
+        initialize(start, goal);
+    } else {
+        sink.log("D* Lite: repairing after edits...");
+        m_km = add(m_km, heuristic(m_last, start.id));
+        m_last = start.id;
+        applyEdits();
+    }
+    res.visitedCount = computeShortestPath(sink);
+
+    // Walk downhill: each step to the successor minimizing edge + g
+    if (m_rhs[start.id] != INF) {
+        int v = start.id;
+        res.path.push_back(start);
+        while (v != m_goal && (int)res.path.size() <= n) {
+            int next = -1, best = INF, step = 0;
+            forEachAdjacent(v, [&](int u, int cost) {
+                if (!m_enter[u]) return;
+                int via = add(cost * m_enter[u], m_g[u]);
+                if (via < best) {
+                    best = via;
+                    next = u;
+                    step = cost * m_enter[u];
+                }
+            });
+            if (next < 0) break;
+            res.totalCost += step;
+            v = next;
+            res.path.push_back(Node{ v });
+        }
+        res.success = v == m_goal;
+        if (!res.success) {
+            res.path.clear();
+            res.totalCost = 0;
+        }
+    }
+    sink.log(res.success ? "Path reconstruction complete." : "Failure: No path could be found to target.");
+    res.timeMs = elapsedMs(startTime);
+    return res;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "Algorithms.h"
+#include "Grid.h"
+#include <utility>
+#include <vector>
+
+// Incremental replanning on a Grid (D* Lite, Koenig & Likhachev). The planner
+// searches backward from the goal and keeps its g/rhs values between calls. It
+// subscribes to the grid's edits: cells changed since the last plan() only
+// re-open the nodes whose cheapest edge ran through them, so repairing after a
+// small edit expands a number of nodes that follows the edit, not the map.
+// Moving the start is cheap as well (the queue keys absorb the shift through
+// km); a new goal, a maze, a load or toggling diagonals starts a fresh search.
+//
+// totalCost equals runDijkstra's; the path may differ among equally short ones.
+// visitedCount is the number of nodes expanded by this call only.
+// Not thread-safe: edits must not race with plan().
+class DStarLite : public IGridListener {
+public:
+    explicit DStarLite(Grid& grid);
+    ~DStarLite() override;
+    DStarLite(const DStarLite&) = delete;
+    DStarLite& operator=(const DStarLite&) = delete;
+
+    AlgoResult plan(Node start, Node goal, IAlgorithmObserver* observer = nullptr);
+
+    // False once the grid has been destroyed; plan() then fails
+    bool attached() const { return m_grid != nullptr; }
+
+    void onCellChanged(Node cell) override;
+    void onGridReset() override { m_fresh = true; }
+    void onGridDestroyed() override { m_grid = nullptr; }
+
+private:
+    using Key = std::pair<int, int>;
+    static constexpr Key UNQUEUED = { -1, -1 };
+
+    void initialize(Node start, Node goal);
+    void applyEdits(); // Folds the edited cells into rhs (the D* Lite edge-cost update)
+    template <typename Sink>
+    int computeShortestPath(const Sink& sink); // Returns the expansion count
+
+    Key key(int v) const;
+    void updateVertex(int v);
+    int bestRhs(int v) const; // min over successors of edge + g
+    int heuristic(int a, int b) const;
+    // visit(neighbour, straight/diagonal step cost) over the 4 or 8 cells around v
+    template <typename F>
+    void forEachAdjacent(int v, F&& visit) const;
+
+    Grid* m_grid;
+    int m_width = 0, m_height = 0;
+    bool m_diagonal = false;
+    bool m_fresh = true; // Next plan() starts over
+    int m_goal = -1;
+    int m_last = -1; // Start of the previous plan()
+    int m_km = 0;
+    std::vector<int> m_g, m_rhs;
+    std::vector<int> m_enter; // Entry cost multiplier as last planned over, 0 for walls
+    std::vector<Key> m_queued; // Key a node is queued under, UNQUEUED if none
+    std::vector<std::pair<Key, int>> m_heap; // Lazy min-heap: entries not matching m_queued are stale
+    std::vector<int> m_edited;
+    std::vector<char> m_isEdited;
+};
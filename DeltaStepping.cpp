@@ -0,0 +1,197 @@
+#include "DeltaStepping.h"
+#include "SearchKernels.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+constexpr size_t NO_BUCKET = std::numeric_limits<size_t>::max();
+
+uint64_t pack(int dist, int parent) { return (uint64_t)(uint32_t)dist << 32 | (uint32_t)parent; }
+int distOf(uint64_t state) { return (int)(state >> 32); }
+int parentOf(uint64_t state) { return (int)(uint32_t)state; }
+
+} // namespace
+
+DeltaSteppingEngine::DeltaSteppingEngine(int threads) : m_pool(threads) {
+    for (int i = 0; i < m_pool.threadCount(); ++i) m_workers.push_back(std::make_unique<Worker>());
+}
+
+void DeltaSteppingEngine::work(int self) {
+    dispatchGraph(*m_graph, nullptr, [&](const auto& view, const auto&) {
+        if (m_mode == FieldMode::ToSources) search<true>(self, view);
+        else search<false>(self, view);
+    });
+}
+
+void DeltaSteppingEngine::push(Worker& w, int node, int dist) {
+    size_t bucket = (size_t)dist / (size_t)m_delta;
+    if (bucket >= w.buckets.size()) w.buckets.resize(bucket + 1);
+    w.buckets[bucket].push_back({ node, dist });
+}
+
+// Lowers node to dist unless something already got it at least as low
+void DeltaSteppingEngine::relax(Worker& w, int node, int dist, int parent) {
+    std::atomic<uint64_t>& state = m_state[node];
+    uint64_t current = state.load(std::memory_order_relaxed);
+    while (distOf(current) > dist) {
+        if (state.compare_exchange_weak(current, pack(dist, parent), std::memory_order_relaxed)) {
+            push(w, node, dist);
+            return;
+        }
+    }
+}
+
+// Every worker's frontier, as one list handed out in chunks to whoever asks first
+template <typename F>
+void DeltaSteppingEngine::forEachFrontierEntry(int slot, F&& visit) {
+    const int threads = threadCount();
+    size_t total = 0;
+    for (const auto& w : m_workers) total += w->frontierSize[slot];
+    const size_t chunk = std::max<size_t>(16, std::min<size_t>(1024, total / (threads * 8)));
+    while (true) {
+        size_t begin = m_cursor.fetch_add(chunk, std::memory_order_relaxed);
+        if (begin >= total) return;
+        size_t end = std::min(total, begin + chunk);
+        size_t offset = 0;
+        for (int t = 0; t < threads && begin < end; ++t) {
+            size_t size = m_workers[t]->frontierSize[slot];
+            if (begin < offset + size) {
+                const Entry* list = m_workers[t]->frontier.data() - offset;
+                size_t stop = std::min(end, offset + size);
+                for (size_t i = begin; i < stop; ++i) visit(list[i]);
+                begin = stop;
+            }
+            offset += size;
+        }
+    }
+}
+
+// Run by every worker in lockstep; the barriers separate the phases
+template <bool Reverse, typename Graph>
+void DeltaSteppingEngine::search(int self, const Graph& graph) {
+    Worker& w = *m_workers[self];
+    const int threads = threadCount();
+    const size_t n = (size_t)m_graph->nodeCount();
+    const int delta = m_delta;
+
+    w.buckets.clear();
+    w.settled.clear();
+    for (size_t i = n * self / threads, end = n * (self + 1) / threads; i < end; ++i) {
+        m_state[i].store(pack(SearchWorkspace::INF, -1), std::memory_order_relaxed);
+    }
+    m_pool.barrier();
+
+    if (self == 0) {
+        for (Node s : *m_sources) {
+            if (s.id < 0 || (size_t)s.id >= n || distOf(m_state[s.id].load(std::memory_order_relaxed)) == 0) continue;
+            m_state[s.id].store(pack(0, -1), std::memory_order_relaxed);
+            push(w, s.id, 0);
+        }
+    }
+
+    auto findNext = [&](size_t from) {
+        while (from < w.buckets.size() && w.buckets[from].empty()) ++from;
+        return from < w.buckets.size() ? from : NO_BUCKET;
+    };
+    // Moves this worker's part of the next round into frontier and publishes its size
+    int slot = 0;
+    auto beginRound = [&](std::vector<Entry>& source) {
+        slot ^= 1;
+        w.frontier.swap(source);
+        source.clear();
+        w.frontierSize[slot] = w.frontier.size();
+        if (self == 0) m_cursor.store(0, std::memory_order_relaxed);
+        m_pool.barrier();
+        size_t total = 0;
+        for (const auto& other : m_workers) total += other->frontierSize[slot];
+        return total != 0;
+    };
+    std::vector<Entry> empty;
+
+    w.nextBucket = findNext(0);
+    m_pool.barrier();
+    while (true) {
+        size_t bucket = NO_BUCKET;
+        for (const auto& other : m_workers) bucket = std::min(bucket, other->nextBucket);
+        if (bucket == NO_BUCKET) break;
+
+        // Light edges, repeated while they keep refilling this bucket
+        while (beginRound(bucket < w.buckets.size() ? w.buckets[bucket] : empty)) {
+            forEachFrontierEntry(slot, [&](Entry e) {
+                if (distOf(m_state[e.node].load(std::memory_order_relaxed)) != e.dist) return; // Stale
+                w.settled.push_back(e);
+                auto visit = [&](Node target, int weight) {
+                    if (weight <= delta) relax(w, target.id, e.dist + weight, e.node);
+                };
+                if (Reverse) graph.forEachPredecessor(Node{ e.node }, visit);
+                else graph.forEachNeighbor(Node{ e.node }, visit);
+            });
+            m_pool.barrier();
+        }
+
+        // Heavy edges of everything settled here; they only reach later buckets
+        if (beginRound(w.settled)) {
+            forEachFrontierEntry(slot, [&](Entry e) {
+                if (distOf(m_state[e.node].load(std::memory_order_relaxed)) != e.dist) return; // Re-expanded lower
+                auto visit = [&](Node target, int weight) {
+                    if (weight > delta) relax(w, target.id, e.dist + weight, e.node);
+                };
+                if (Reverse) graph.forEachPredecessor(Node{ e.node }, visit);
+                else graph.forEachNeighbor(Node{ e.node }, visit);
+            });
+        }
+        if (bucket < w.buckets.size()) std::vector<Entry>().swap(w.buckets[bucket]);
+        w.nextBucket = findNext(bucket + 1);
+        m_pool.barrier();
+    }
+
+    // Unpack into the output, one slice each
+    int reached = 0;
+    for (size_t i = n * self / threads, end = n * (self + 1) / threads; i < end; ++i) {
+        uint64_t state = m_state[i].load(std::memory_order_relaxed);
+        bool hit = distOf(state) != SearchWorkspace::INF;
+        m_out->dist[i] = hit ? distOf(state) : -1;
+        m_out->parent[i] = parentOf(state);
+        reached += hit;
+    }
+    w.reached = reached;
+}
+
+// Roughly twice the mean edge weight, sampled from evenly spaced nodes
+int DeltaSteppingEngine::chooseDelta(const IGraph& graph) const {
+    const int n = graph.nodeCount();
+    const int samples = std::min(n, 1024);
+    std::vector<Edge> edges;
+    long long sum = 0, count = 0;
+    for (int i = 0; i < samples; ++i) {
+        graph.getNeighbors(Node{ (int)((long long)n * i / samples) }, edges);
+        for (const Edge& e : edges) sum += e.weight;
+        count += edges.size();
+    }
+    return count ? (int)std::max<long long>(1, 2 * sum / count) : 1;
+}
+
+void DeltaSteppingEngine::run(const IGraph& graph, const std::vector<Node>& sources, DistanceField& out,
+                              FieldMode mode, int delta) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    const size_t n = (size_t)graph.nodeCount();
+    if (m_stateSize < n) {
+        m_state.reset(new std::atomic<uint64_t>[n]);
+        m_stateSize = n;
+    }
+    out.dist.resize(n);
+    out.parent.resize(n);
+
+    m_graph = &graph;
+    m_sources = &sources;
+    m_mode = mode;
+    m_delta = delta > 0 ? delta : chooseDelta(graph);
+    m_out = &out;
+    m_pool.run([this](int self) { work(self); });
+
+    out.reachedCount = 0;
+    for (const auto& w : m_workers) out.reachedCount += w->reached;
+    updateFieldDirections(graph, out);
+    out.timeMs = elapsedMs(startTime);
+}
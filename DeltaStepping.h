@@ -0,0 +1,77 @@
+#pragma once
+#include "DistanceField.h"
+#include "WorkerPool.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Parallel one-to-all shortest paths (Meyer & Sanders' delta-stepping) for maps
+// too large for a sequential distance field. Tentative distances are grouped into
+// buckets of width delta; the lowest bucket is settled by relaxing its light
+// edges (weight <= delta) in parallel rounds until it stops changing, then the
+// heavy edges of everything it settled are relaxed once, and the next non-empty
+// bucket follows. Distances are exact: dist and reachedCount equal
+// computeDistanceField's (and so runDijkstra's totalCost). parent may pick a
+// different one of several equally short predecessors, and which one can vary
+// between runs.
+//
+// Edge weights must be non-negative. Like ParallelQueryEngine, the graph is read
+// concurrently through its const interface (see WorkerPool for Wasm).
+class DeltaSteppingEngine {
+public:
+    explicit DeltaSteppingEngine(int threads = 0); // 0 = hardware concurrency
+
+    // Worker count, the calling thread included
+    int threadCount() const { return m_pool.threadCount(); }
+
+    // Same contract as computeDistanceField. delta <= 0 derives the bucket width
+    // from a sample of edge weights. One run at a time per engine.
+    void run(const IGraph& graph, const std::vector<Node>& sources, DistanceField& out,
+             FieldMode mode = FieldMode::ToSources, int delta = 0);
+
+    // Bucket width used by the last run
+    int lastDelta() const { return m_delta; }
+
+private:
+    // A bucket entry: node pushed when its tentative distance dropped to dist.
+    // Entries whose dist no longer matches the node's are stale and skipped.
+    struct Entry {
+        int node;
+        int dist;
+    };
+
+    struct Worker {
+        std::vector<std::vector<Entry>> buckets; // By bucket index, filled by this worker only
+        std::vector<Entry> frontier;             // This worker's share of the round being processed
+        std::vector<Entry> settled;              // Expanded in the current bucket, for the heavy pass
+        size_t frontierSize[2] = { 0, 0 };       // Published per round, alternating so a slow reader never sees the next round's
+        size_t nextBucket = 0;                   // Lowest non-empty bucket after the current one
+        int reached = 0;
+    };
+
+    void work(int self);
+    template <bool Reverse, typename Graph>
+    void search(int self, const Graph& graph);
+    template <typename F>
+    void forEachFrontierEntry(int slot, F&& visit);
+    void relax(Worker& w, int node, int dist, int parent);
+    void push(Worker& w, int node, int dist);
+    int chooseDelta(const IGraph& graph) const;
+
+    WorkerPool m_pool;
+    std::vector<std::unique_ptr<Worker>> m_workers; // Indexed like the pool's workers
+
+    // Current job
+    const IGraph* m_graph = nullptr;
+    const std::vector<Node>* m_sources = nullptr;
+    FieldMode m_mode = FieldMode::ToSources;
+    int m_delta = 1;
+    DistanceField* m_out = nullptr;
+
+    // Search state: distance in the high 32 bits and parent in the low 32, so one
+    // compare-and-swap keeps the pair consistent
+    std::unique_ptr<std::atomic<uint64_t>[]> m_state;
+    size_t m_stateSize = 0;
+    std::atomic<size_t> m_cursor{ 0 }; // Next unclaimed chunk of the current round
+};
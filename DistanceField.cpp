@@ -0,0 +1,74 @@
+#include "DistanceField.h"
+#include "SearchKernels.h"
+#include <algorithm>
+
+void updateFieldDirections(const IGraph& graph, DistanceField& field) {
+    field.direction.clear();
+    const Grid* grid = dynamic_cast<const Grid*>(&graph);
+    if (!grid) return;
+    // Same offsets as Grid::forEachNeighbor; (dx + 1) * 3 + (dy + 1) -> direction index
+    static constexpr int8_t codes[9] = { 4, 0, 5, 2, -1, 3, 6, 1, 7 };
+    const int width = grid->getWidth();
+    field.direction.assign(field.parent.size(), -1);
+    for (size_t i = 0; i < field.parent.size(); ++i) {
+        int p = field.parent[i];
+        if (p < 0) continue;
+        int dx = p / width - (int)i / width;
+        int dy = p % width - (int)i % width;
+        field.direction[i] = codes[(dx + 1) * 3 + (dy + 1)];
+    }
+}
+
+std::vector<Node> extractFieldPath(const IGraph& graph, const DistanceField& field, Node from, FieldMode mode) {
+    std::vector<Node> path;
+    const int n = (int)field.dist.size();
+    if (from.id < 0 || from.id >= n || field.dist[from.id] < 0) return path;
+    const bool hasParents = field.parent.size() == field.dist.size();
+    std::vector<Edge> edges;
+    Node curr = from;
+    path.push_back(curr);
+    while (field.dist[curr.id] > 0 && (int)path.size() <= n) {
+        int next = -1;
+        if (hasParents) {
+            next = field.parent[curr.id];
+        } else {
+            // Any edge that accounts for the whole difference lies on a shortest path
+            if (mode == FieldMode::ToSources) graph.getNeighbors(curr, edges);
+            else graph.getPredecessors(curr, edges);
+            for (const Edge& e : edges) {
+                int d = field.dist[e.target.id];
+                if (d >= 0 && d + e.weight == field.dist[curr.id]) {
+                    next = e.target.id;
+                    break;
+                }
+            }
+        }
+        if (next < 0) return {}; // Inconsistent field
+        curr = Node{ next };
+        path.push_back(curr);
+    }
+    if (mode == FieldMode::FromSources) std::reverse(path.begin(), path.end());
+    return path;
+}
+
+void computeDistanceField(const IGraph& graph, const std::vector<Node>& sources, DistanceField& out,
+                          FieldMode mode, QueueKind queue) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    dispatchQueue(queue, [&](auto tag) {
+        using Q = typename decltype(tag)::type;
+        Q pq;
+        dispatchGraph(graph, nullptr, [&](const auto& view, const auto&) {
+            out.reachedCount = mode == FieldMode::ToSources
+                ? distanceFieldSearch<true>(view, sources, out.dist, out.parent, pq)
+                : distanceFieldSearch<false>(view, sources, out.dist, out.parent, pq);
+        });
+    });
+    for (int& d : out.dist) {
+        if (d == SearchWorkspace::INF) d = -1;
+    }
+
+    updateFieldDirections(graph, out);
+
+    out.timeMs = elapsedMs(startTime);
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "Algorithms.h"
+#include <cstdint>
+#include <vector>
+
+// One-to-all (and many-to-all) shortest paths: the whole distance field around a
+// set of sources instead of a single path, e.g. a flow field that any number of
+// agents can follow to the nearest goal.
+
+enum class FieldMode {
+    ToSources,  // dist = cost from the node to its nearest source; parent = next step toward it
+    FromSources // dist = cost from the nearest source to the node; parent = previous step (shortest-path tree)
+};
+
+// Dense, flat arrays indexed by Node::id, handed out as-is (typed-array views in Wasm).
+// Grid weights are entry costs, so the two modes differ on weighted grids.
+struct DistanceField {
+    std::vector<int> dist;         // -1 if unreachable
+    std::vector<int> parent;       // -1 at sources and unreachable nodes
+    std::vector<int8_t> direction; // Grids only (empty otherwise): step from the node to parent
+                                   // as an index into Grid::getNeighbors order
+                                   // (up, down, left, right, up-left, up-right, down-left, down-right), -1 if none
+    int reachedCount = 0;
+    double timeMs = 0;
+};
+
+// Multi-source Dijkstra over the whole graph. Sources outside [0, nodeCount) are ignored.
+// out's buffers are reused when it is passed again.
+void computeDistanceField(const IGraph& graph, const std::vector<Node>& sources, DistanceField& out,
+                          FieldMode mode = FieldMode::ToSources, QueueKind queue = QueueKind::BinaryHeap);
+
+// Rebuilds field.direction from field.parent (emptied for graphs other than Grid)
+void updateFieldDirections(const IGraph& graph, DistanceField& field);
+
+// Path read off a field, starting at from: to its nearest source for ToSources,
+// from the nearest source to it for FromSources (mode must match the field's).
+// Follows field.parent when it is filled, otherwise walks dist downhill over
+// getNeighbors (ToSources) or getPredecessors (FromSources). Empty if from is unreachable.
+std::vector<Node> extractFieldPath(const IGraph& graph, const DistanceField& field, Node from, FieldMode mode);
@@ -1,68 +1,74 @@
 #include "Grid.h"
 #include <iomanip>
+#include <algorithm>
 
 Grid::Grid(int height, int width) : width(width), height(height), source({0, 0}), destination({height-1, width-1}) {
-    map.resize(height, std::vector<char>(width, '.'));
-    weights.resize(height, std::vector<int>(width, 1)); // Default weight 1
-    if (isValid(source.x, source.y)) map[source.x][source.y] = 'S';
-    if (isValid(destination.x, destination.y)) map[destination.x][destination.y] = 'D';
+    resize(height, width);
+}
+
+void Grid::resize(int h, int w) {
+    height = h;
+    width = w;
+    size_t cells = (size_t)h * w;
+    obstacles.assign((cells + 63) / 64, 0);
+    weights.assign(cells, 1); // Default weight 1
+    weightedCells = 0;
+}
+
+void Grid::storeWeight(int i, int weight) {
+    uint16_t w = (uint16_t)std::max(1, std::min(weight, MAX_WEIGHT));
+    weightedCells += (w != 1) - (weights[i] != 1);
+    weights[i] = w;
+}
+
+char Grid::getChar(int x, int y) const {
+    if (!isValid(x, y)) return '#';
+    if (x == source.x && y == source.y) return 'S';
+    if (x == destination.x && y == destination.y) return 'D';
+    return obstacleAt(index(x, y)) ? '#' : '.';
+}
+
+void Grid::setCell(int i, bool wall, int weight) {
+    uint16_t w = (uint16_t)std::max(1, std::min(weight, MAX_WEIGHT));
+    if (obstacleAt(i) == wall && weights[i] == w) return;
+    setObstacleBit(i, wall);
+    storeWeight(i, w);
+    m_listeners.cellChanged(Node{ i });
 }
 
 void Grid::setWeight(int x, int y, int weight) {
     if (isValid(x, y)) {
-        weights[x][y] = weight;
-        // If it's a wall or visited, make it a normal path so weight applies
-        if (map[x][y] == '#' || map[x][y] == '*' || map[x][y] == 'v') {
-            map[x][y] = '.';
-        }
+        // If it's a wall, make it a normal path so weight applies
+        setCell(index(x, y), false, weight);
     }
 }
 
 void Grid::setEmpty(int x, int y) {
-    if (isValid(x, y) && map[x][y] != 'S' && map[x][y] != 'D') {
-        map[x][y] = '.';
-        weights[x][y] = 1;
+    if (isValid(x, y) && !isEndpoint(x, y)) {
+        setCell(index(x, y), false, 1);
     }
 }
 
 void Grid::setObstacle(int x, int y) {
-    if (isValid(x, y)) {
-        map[x][y] = '#';
+    if (isValid(x, y) && !isEndpoint(x, y)) {
+        int i = index(x, y);
+        setCell(i, true, weights[i]);
     }
 }
 
 void Grid::setSource(int x, int y) {
     if (isValid(x, y)) {
-        if (isValid(source.x, source.y)) map[source.x][source.y] = '.'; 
         source = {x, y};
-        map[x][y] = 'S';
+        int i = index(x, y);
+        setCell(i, false, weights[i]);
     }
 }
 
 void Grid::setDestination(int x, int y) {
     if (isValid(x, y)) {
-        if (isValid(destination.x, destination.y)) map[destination.x][destination.y] = '.'; 
         destination = {x, y};
-        map[x][y] = 'D';
-    }
-}
-
-void Grid::clearPath() {
-    for(int i=0; i<height; ++i) {
-        for(int j=0; j<width; ++j) {
-            // Clear path, visited, current
-            if(map[i][j] == '*' || map[i][j] == 'v' || map[i][j] == 'c') map[i][j] = '.';
-        }
-    }
-    if(isValid(source.x, source.y)) map[source.x][source.y] = 'S';
-    if(isValid(destination.x, destination.y)) map[destination.x][destination.y] = 'D';
-}
-
-void Grid::markPath(const std::vector<Point>& path) {
-    for (const auto& p : path) {
-        if (map[p.x][p.y] != 'S' && map[p.x][p.y] != 'D') {
-            map[p.x][p.y] = '*';
-        }
+        int i = index(x, y);
+        setCell(i, false, weights[i]);
     }
 }
 
@@ -74,95 +80,40 @@ void Grid::print() const {
     for (int i = 0; i < height; ++i) {
         std::cout << i % 10 << " ";
         for (int j = 0; j < width; ++j) {
-            std::cout << map[i][j] << " ";
+            std::cout << getChar(i, j) << " ";
         }
         std::cout << "\n";
     }
 }
 
-bool Grid::isValid(int x, int y) const {
-    return x >= 0 && x < height && y >= 0 && y < width;
-}
+#include "MazeGenerator.h"
+#include <chrono>
 
-bool Grid::isObstacle(int x, int y) const {
-    if (!isValid(x, y)) return true;
-    return map[x][y] == '#';
+uint64_t Grid::generateRandomMaze(uint64_t seed) {
+    if (seed == 0) seed = (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count() | 1;
+    MazeOptions options;
+    options.kind = MazeKind::Noise;
+    options.seed = seed;
+    generateMaze(*this, options);
+    return seed;
 }
 
-void Grid::setVisited(int x, int y) {
-    if (isValid(x, y) && map[x][y] != 'S' && map[x][y] != 'D' && map[x][y] != '#') {
-        map[x][y] = 'v'; // visited
-    }
-}
-
-void Grid::setCurrent(int x, int y) {
-    if (isValid(x, y) && map[x][y] != 'S' && map[x][y] != 'D') {
-        map[x][y] = 'c'; // current head
-    }
-}
-
-#include <cstdlib>
-#include <ctime>
-
-void Grid::generateRandomMaze() {
-    // Simple random maze: 30% obstacles
-    srand(time(0));
-    for(int i=0; i<height; ++i) {
-        for(int j=0; j<width; ++j) {
-            if (map[i][j] != 'S' && map[i][j] != 'D') {
-                if ((rand() % 100) < 30) {
-                    map[i][j] = '#';
-                } else {
-                    map[i][j] = '.';
-                }
-            }
-        }
-    }
+void Grid::getNeighbors(Node n, std::vector<Edge>& neighbors) const {
+    neighbors.clear();
+    auto push = [&](Node target, int weight) { neighbors.push_back({ target, weight }); };
+    if (m_allowDiagonals) forEachNeighbor<true>(n, push);
+    else forEachNeighbor<false>(n, push);
 }
 
-std::vector<Edge> Grid::getNeighbors(Node n) const {
-    Point p = toPoint(n);
-    std::vector<Edge> neighbors;
-    
-    // Orthogonal (Cost 10)
-    const int dx[] = {-1, 1, 0, 0};
-    const int dy[] = {0, 0, -1, 1};
-    for (int i = 0; i < 4; ++i) {
-        int nx = p.x + dx[i];
-        int ny = p.y + dy[i];
-        if (isValid(nx, ny) && !isObstacle(nx, ny)) {
-            neighbors.push_back({ toNode(nx, ny), 10 * getWeight(nx, ny) });
-        }
-    }
-
-    // Diagonal (Cost 14)
-    if (m_allowDiagonals) {
-        const int ddx[] = {-1, -1, 1, 1};
-        const int ddy[] = {-1, 1, -1, 1};
-        for (int i = 0; i < 4; ++i) {
-            int nx = p.x + ddx[i];
-            int ny = p.y + ddy[i];
-            if (isValid(nx, ny) && !isObstacle(nx, ny)) {
-                neighbors.push_back({ toNode(nx, ny), 14 * getWeight(nx, ny) });
-            }
-        }
-    }
-    return neighbors;
+void Grid::getPredecessors(Node n, std::vector<Edge>& predecessors) const {
+    predecessors.clear();
+    auto push = [&](Node source, int weight) { predecessors.push_back({ source, weight }); };
+    if (m_allowDiagonals) forEachPredecessor<true>(n, push);
+    else forEachPredecessor<false>(n, push);
 }
 
 int Grid::getHeuristic(Node startNode, Node targetNode) const {
-    Point s = toPoint(startNode);
-    Point t = toPoint(targetNode);
-    int dx = abs(s.x - t.x);
-    int dy = abs(s.y - t.y);
-
-    if (m_allowDiagonals) {
-        // Octile distance (scaled by 10)
-        return 10 * (dx + dy) + (14 - 2 * 10) * std::min(dx, dy);
-    } else {
-        // Manhattan distance (scaled by 10)
-        return 10 * (dx + dy);
-    }
+    return m_allowDiagonals ? heuristic<true>(startNode, targetNode) : heuristic<false>(startNode, targetNode);
 }
 
 #include <sstream>
@@ -176,60 +127,392 @@ std::string Grid::serialize() const {
     // Map data
     for (int i = 0; i < height; ++i) {
         for (int j = 0; j < width; ++j) {
-            ss << map[i][j];
+            ss << getChar(i, j);
         }
     }
     ss << "|";
 
     // Weight data
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            ss << weights[i][j] << " ";
-        }
+    for (size_t i = 0; i < weights.size(); ++i) {
+        ss << weights[i] << " ";
     }
     
     return ss.str();
 }
 
-bool Grid::load(const std::string& data) {
-    try {
-        size_t pipe1 = data.find('|');
-        size_t pipe2 = data.find('|', pipe1 + 1);
-        if (pipe1 == std::string::npos || pipe2 == std::string::npos) return false;
-
-        std::string header = data.substr(0, pipe1);
-        std::string mapData = data.substr(pipe1 + 1, pipe2 - pipe1 - 1);
-        std::string weightData = data.substr(pipe2 + 1);
-
-        std::stringstream ss(header);
-        char comma;
-        int h, w, sx, sy, dx, dy;
-        if (!(ss >> h >> comma >> w >> comma >> sx >> comma >> sy >> comma >> dx >> comma >> dy)) return false;
-
-        // Resize
-        height = h;
-        width = w;
-        map.assign(height, std::vector<char>(width, '.'));
-        weights.assign(height, std::vector<int>(width, 1));
-
-        // Map
-        if (mapData.length() < (size_t)(height * width)) return false;
-        for (int i = 0; i < height; ++i) {
-            for (int j = 0; j < width; ++j) {
-                map[i][j] = mapData[i * width + j];
+#include <charconv>
+
+void Grid::adopt(int h, int w, Point s, Point d, std::vector<uint64_t>&& bits, std::vector<uint16_t>&& cellWeights) {
+    height = h;
+    width = w;
+    source = s;
+    destination = d;
+    obstacles = std::move(bits);
+    weights = std::move(cellWeights);
+    weightedCells = (int)(weights.size() - std::count(weights.begin(), weights.end(), uint16_t(1)));
+    m_listeners.reset();
+}
+
+namespace {
+
+// Single-pass parser for the serialize() text format, fed in arbitrary chunks:
+//   h,w,sx,sy,dx,dy|<h*w map chars>|<h*w whitespace-separated weights>
+// Numbers go through std::from_chars (no locale, no allocation); only a number
+// split across two chunks is buffered.
+class TextGridParser {
+public:
+    int h = 0, w = 0;
+    Point source = {0, 0}, destination = {0, 0};
+    std::vector<uint64_t> obstacles;
+    std::vector<uint16_t> weights;
+    GridLoadError error;
+
+    // last marks the end of input. Returns false once the input is known to be bad.
+    bool feed(std::string_view chunk, bool last) {
+        if (!consume(chunk, last)) return false;
+        m_base += chunk.size();
+        return !last || finish();
+    }
+
+private:
+    enum Stage { HEADER, MAP, WEIGHTS };
+    static constexpr size_t MAX_TOKEN = 32;
+
+    static bool isSpace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+    static bool isHeaderDelim(char c) { return c == ',' || c == '|' || isSpace(c); }
+
+    bool fail(size_t offset, std::string message) {
+        error.offset = offset;
+        error.message = std::move(message);
+        return false;
+    }
+
+    // Scans the token starting at i. Returns false with more == true when it may continue in the next chunk.
+    bool takeToken(std::string_view chunk, size_t& i, bool last, bool (*isDelim)(char),
+                   std::string_view& token, size_t& offset, bool& more) {
+        size_t start = i;
+        while (i < chunk.size() && !isDelim(chunk[i])) ++i;
+        more = false;
+        if (m_pending.empty()) {
+            token = chunk.substr(start, i - start);
+            offset = m_base + start;
+        } else {
+            m_pending.append(chunk.data() + start, i - start);
+            token = m_pending;
+            offset = m_pendingOffset;
+        }
+        if (i == chunk.size() && !last) {
+            if (token.size() > MAX_TOKEN) return fail(offset, "number too long");
+            if (m_pending.empty()) {
+                m_pending.assign(token.data(), token.size());
+                m_pendingOffset = offset;
             }
+            more = true;
+            return false;
         }
+        return true;
+    }
+
+    bool parseInt(std::string_view token, size_t offset, const char* what, int& value) {
+        auto res = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (res.ec == std::errc::result_out_of_range) return fail(offset, std::string(what) + " is out of range");
+        if (token.empty() || res.ec != std::errc() || res.ptr != token.data() + token.size())
+            return fail(offset, std::string("expected integer ") + what);
+        return true;
+    }
+
+    bool validateHeader() {
+        h = m_header[0];
+        w = m_header[1];
+        if (h <= 0) return fail(m_fieldOffset[0], "height must be positive");
+        if (w <= 0) return fail(m_fieldOffset[1], "width must be positive");
+        if ((int64_t)h * w > INT32_MAX) return fail(m_fieldOffset[0], "grid has too many cells");
+        source = { m_header[2], m_header[3] };
+        destination = { m_header[4], m_header[5] };
+        auto inside = [&](Point p) { return p.x >= 0 && p.x < h && p.y >= 0 && p.y < w; };
+        if (!inside(source)) return fail(m_fieldOffset[2], "source is outside the grid");
+        if (!inside(destination)) return fail(m_fieldOffset[4], "destination is outside the grid");
+        m_cells = (size_t)h * w;
+        obstacles.assign((m_cells + 63) / 64, 0);
+        weights.assign(m_cells, 1);
+        return true;
+    }
+
+    bool consume(std::string_view chunk, bool last) {
+        static const char* headerNames[] = { "height", "width", "source x", "source y", "destination x", "destination y" };
+        size_t i = 0, n = chunk.size();
+        std::string_view token;
+        size_t offset;
+        bool more;
+        while (true) {
+            switch (m_stage) {
+            case HEADER:
+                if (m_pending.empty()) {
+                    while (i < n && isSpace(chunk[i])) ++i;
+                    if (i == n) return true;
+                }
+                if (m_expectDelim) {
+                    char expected = m_fields < 6 ? ',' : '|';
+                    if (chunk[i] != expected) return fail(m_base + i, std::string("expected '") + expected + "' in header");
+                    ++i;
+                    m_expectDelim = false;
+                    if (m_fields == 6) {
+                        if (!validateHeader()) return false;
+                        m_stage = MAP;
+                    }
+                    continue;
+                }
+                if (!takeToken(chunk, i, last, isHeaderDelim, token, offset, more)) return more;
+                if (!parseInt(token, offset, headerNames[m_fields], m_header[m_fields])) return false;
+                m_fieldOffset[m_fields] = offset;
+                m_pending.clear();
+                ++m_fields;
+                m_expectDelim = true;
+                break;
 
-        // Weights
-        std::stringstream wss(weightData);
-        for (int i = 0; i < height; ++i) {
-            for (int j = 0; j < width; ++j) {
-                if (!(wss >> weights[i][j])) break;
+            case MAP:
+                while (i < n && m_cell < m_cells) {
+                    char c = chunk[i];
+                    if (c == '#') obstacles[m_cell >> 6] |= uint64_t(1) << (m_cell & 63);
+                    // Visualization marks ('*', 'v', 'c') in older files read as open cells
+                    else if (c != '.' && c != 'S' && c != 'D' && c != '*' && c != 'v' && c != 'c')
+                        return fail(m_base + i, std::string("unexpected map character '") + c + "'");
+                    ++i;
+                    ++m_cell;
+                }
+                if (i == n) return true;
+                if (chunk[i] != '|') return fail(m_base + i, "map has more than " + std::to_string(m_cells) + " cells");
+                ++i;
+                m_cell = 0;
+                m_stage = WEIGHTS;
+                break;
+
+            case WEIGHTS:
+                if (m_pending.empty()) {
+                    while (i < n && isSpace(chunk[i])) ++i;
+                    if (i == n) return true;
+                }
+                if (!takeToken(chunk, i, last, isSpace, token, offset, more)) return more;
+                if (m_cell == m_cells) return fail(offset, "more than " + std::to_string(m_cells) + " weights");
+                int value;
+                if (!parseInt(token, offset, "weight", value)) return false;
+                m_pending.clear();
+                weights[m_cell++] = (uint16_t)std::max(1, std::min(value, Grid::MAX_WEIGHT));
+                break;
             }
         }
+    }
 
-        source = {sx, sy};
-        destination = {dx, dy};
+    bool finish() {
+        switch (m_stage) {
+        case HEADER: return fail(m_base, "input ends inside the header");
+        case MAP: return fail(m_base, "map ends after " + std::to_string(m_cell) + " of " + std::to_string(m_cells) + " cells");
+        case WEIGHTS:
+            if (m_cell != m_cells) return fail(m_base, "found " + std::to_string(m_cell) + " of " + std::to_string(m_cells) + " weights");
+            return true;
+        }
         return true;
-    } catch (...) { return false; }
+    }
+
+    Stage m_stage = HEADER;
+    size_t m_base = 0; // Absolute offset of the current chunk
+    int m_header[6] = {};
+    size_t m_fieldOffset[6] = {};
+    int m_fields = 0;
+    bool m_expectDelim = false;
+    size_t m_cells = 0;
+    size_t m_cell = 0;
+    std::string m_pending; // Token split across chunks
+    size_t m_pendingOffset = 0;
+};
+
+} // namespace
+
+bool Grid::load(std::string_view data, GridLoadError* error) {
+    if (isBinaryFormat(data.data(), data.size())) return loadBinary(data.data(), data.size(), error);
+    TextGridParser parser;
+    if (!parser.feed(data, true)) {
+        if (error) *error = parser.error;
+        return false;
+    }
+    adopt(parser.h, parser.w, parser.source, parser.destination, std::move(parser.obstacles), std::move(parser.weights));
+    return true;
+}
+
+bool Grid::load(std::istream& in, GridLoadError* error) {
+    std::vector<char> buffer(1 << 16);
+    in.read(buffer.data(), buffer.size());
+    size_t got = (size_t)in.gcount();
+    if (isBinaryFormat(buffer.data(), got)) {
+        std::string data(buffer.data(), got);
+        data.append(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return loadBinary(data.data(), data.size(), error);
+    }
+    TextGridParser parser;
+    while (true) {
+        bool last = !in;
+        if (!parser.feed(std::string_view(buffer.data(), got), last)) {
+            if (error) *error = parser.error;
+            return false;
+        }
+        if (last) break;
+        in.read(buffer.data(), buffer.size());
+        got = (size_t)in.gcount();
+    }
+    adopt(parser.h, parser.w, parser.source, parser.destination, std::move(parser.obstacles), std::move(parser.weights));
+    return true;
+}
+
+#include <cstddef>
+#include <cstring>
+
+// Binary layout, little-endian, all sections 8-byte aligned:
+//   BinaryHeader (48 bytes)
+//   obstacle bitset: ceil(h*w / 64) uint64 words, same bit order as Grid::obstacles
+//   weight plane:    absent if WEIGHTS_UNIFORM, else h*w values of weightBytes each,
+//                    or with WEIGHTS_RLE, (uint32 run, value) pairs covering h*w cells
+namespace {
+struct BinaryHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    int32_t height, width;
+    int32_t sourceX, sourceY, destX, destY;
+    uint8_t weightBytes; // 1 when every weight fits in a byte, else 2
+    uint8_t reserved[7];
+    uint64_t weightPayload; // Size in bytes of the weight plane
+};
+static_assert(sizeof(BinaryHeader) == 48, "BinaryHeader must stay packed");
+
+const char BINARY_MAGIC[4] = { 'G', 'R', 'D', 'B' };
+const uint16_t BINARY_VERSION = 1;
+const uint16_t WEIGHTS_UNIFORM = 1;
+const uint16_t WEIGHTS_RLE = 2;
+}
+
+bool Grid::isBinaryFormat(const char* data, size_t size) {
+    return size >= sizeof(BinaryHeader) && std::memcmp(data, BINARY_MAGIC, 4) == 0;
+}
+
+std::string Grid::serializeBinary() const {
+    size_t cells = weights.size();
+    BinaryHeader header = {};
+    std::memcpy(header.magic, BINARY_MAGIC, 4);
+    header.version = BINARY_VERSION;
+    header.height = height;
+    header.width = width;
+    header.sourceX = source.x;
+    header.sourceY = source.y;
+    header.destX = destination.x;
+    header.destY = destination.y;
+    header.weightBytes = 1;
+
+    size_t runs = 0;
+    for (size_t i = 0; i < cells; ++i) {
+        if (weights[i] > UINT8_MAX) header.weightBytes = 2;
+        if (i == 0 || weights[i] != weights[i - 1]) ++runs;
+    }
+    size_t rawSize = cells * header.weightBytes;
+    size_t rleSize = runs * (4 + header.weightBytes);
+    if (weightedCells == 0) header.flags |= WEIGHTS_UNIFORM;
+    else if (rleSize < rawSize) header.flags |= WEIGHTS_RLE;
+    header.weightPayload = (header.flags & WEIGHTS_UNIFORM) ? 0 : (header.flags & WEIGHTS_RLE) ? rleSize : rawSize;
+
+    size_t bitsetSize = obstacles.size() * sizeof(uint64_t);
+    std::string out;
+    out.resize(sizeof(header) + bitsetSize + header.weightPayload);
+    char* p = &out[0];
+    std::memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    std::memcpy(p, obstacles.data(), bitsetSize);
+    p += bitsetSize;
+
+    auto putWeight = [&](uint16_t w) {
+        if (header.weightBytes == 1) *p++ = (char)w;
+        else { std::memcpy(p, &w, 2); p += 2; }
+    };
+    if (header.flags & WEIGHTS_RLE) {
+        for (size_t i = 0; i < cells;) {
+            size_t j = i;
+            while (j < cells && j - i < UINT32_MAX && weights[j] == weights[i]) ++j;
+            uint32_t run = (uint32_t)(j - i);
+            std::memcpy(p, &run, 4);
+            p += 4;
+            putWeight(weights[i]);
+            i = j;
+        }
+    } else if (!(header.flags & WEIGHTS_UNIFORM)) {
+        if (header.weightBytes == 2) std::memcpy(p, weights.data(), rawSize);
+        else for (size_t i = 0; i < cells; ++i) putWeight(weights[i]);
+    }
+    return out;
+}
+
+bool Grid::loadBinary(const char* data, size_t size, GridLoadError* error) {
+    auto fail = [&](size_t offset, const char* message) {
+        if (error) *error = { offset, message };
+        return false;
+    };
+    if (!isBinaryFormat(data, size)) return fail(0, "not a binary grid");
+    BinaryHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version != BINARY_VERSION) return fail(offsetof(BinaryHeader, version), "unsupported binary grid version");
+    if (header.height <= 0 || header.width <= 0) return fail(offsetof(BinaryHeader, height), "grid dimensions must be positive");
+    if ((int64_t)header.height * header.width > INT32_MAX) return fail(offsetof(BinaryHeader, height), "grid has too many cells");
+    if (header.weightBytes != 1 && header.weightBytes != 2) return fail(offsetof(BinaryHeader, weightBytes), "weight size must be 1 or 2 bytes");
+    int h = header.height, w = header.width;
+    auto inside = [&](int x, int y) { return x >= 0 && x < h && y >= 0 && y < w; };
+    if (!inside(header.sourceX, header.sourceY)) return fail(offsetof(BinaryHeader, sourceX), "source is outside the grid");
+    if (!inside(header.destX, header.destY)) return fail(offsetof(BinaryHeader, destX), "destination is outside the grid");
+
+    size_t cells = (size_t)h * w;
+    size_t bitsetSize = (cells + 63) / 64 * sizeof(uint64_t);
+    if (size - sizeof(header) < bitsetSize) return fail(size, "obstacle bitset is truncated");
+    if (size - sizeof(header) - bitsetSize < header.weightPayload) return fail(size, "weight plane is truncated");
+    const char* p = data + sizeof(header);
+    const char* weightData = p + bitsetSize;
+    size_t weightOffset = sizeof(header) + bitsetSize;
+    size_t stride = 4 + header.weightBytes;
+    if (header.flags & WEIGHTS_UNIFORM) {
+        if (header.weightPayload != 0) return fail(offsetof(BinaryHeader, weightPayload), "uniform grid has a weight plane");
+    } else if (header.flags & WEIGHTS_RLE) {
+        // Check the runs cover the grid exactly before decoding anything
+        if (header.weightPayload % stride) return fail(offsetof(BinaryHeader, weightPayload), "weight plane is not a whole number of runs");
+        uint64_t covered = 0;
+        for (size_t off = 0; off < header.weightPayload; off += stride) {
+            uint32_t run;
+            std::memcpy(&run, weightData + off, 4);
+            covered += run;
+            if (covered > cells) return fail(weightOffset + off, "weight runs cover more cells than the grid");
+        }
+        if (covered != cells) return fail(weightOffset + header.weightPayload, "weight runs cover fewer cells than the grid");
+    } else if (header.weightPayload != cells * header.weightBytes) {
+        return fail(offsetof(BinaryHeader, weightPayload), "weight plane size does not match the grid");
+    }
+
+    std::vector<uint64_t> bits(bitsetSize / sizeof(uint64_t));
+    std::memcpy(bits.data(), p, bitsetSize);
+    if (cells % 64) bits.back() &= (uint64_t(1) << (cells % 64)) - 1;
+
+    // Weight 0 is not representable in a Grid; treat it like storeWeight does
+    std::vector<uint16_t> cellWeights(cells, 1);
+    auto weightAt = [&](const char* q) {
+        uint16_t v = (uint8_t)q[0];
+        if (header.weightBytes == 2) std::memcpy(&v, q, 2);
+        return std::max<uint16_t>(v, 1);
+    };
+    if (header.flags & WEIGHTS_RLE) {
+        size_t filled = 0;
+        for (size_t off = 0; off < header.weightPayload; off += stride) {
+            uint32_t run;
+            std::memcpy(&run, weightData + off, 4);
+            std::fill_n(cellWeights.begin() + filled, run, weightAt(weightData + off + 4));
+            filled += run;
+        }
+    } else if (!(header.flags & WEIGHTS_UNIFORM)) {
+        for (size_t i = 0; i < cells; ++i) cellWeights[i] = weightAt(weightData + i * header.weightBytes);
+    }
+
+    adopt(h, w, { header.sourceX, header.sourceY }, { header.destX, header.destY }, std::move(bits), std::move(cellWeights));
+    return true;
 }
@@ -1,7 +1,12 @@
 #pragma once
 #include "IGraph.h"
 #include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
 #include <iostream>
+#include <string>
+#include <string_view>
 
 struct Point {
     int x, y;
@@ -10,6 +15,46 @@ struct Point {
     bool operator<(const Point& other) const { return x < other.x || (x == other.x && y < other.y); }
 };
 
+// Why Grid::load rejected its input. offset is the byte position of the problem.
+struct GridLoadError {
+    size_t offset = 0;
+    std::string message;
+};
+
+// Receives a Grid's edits as they happen (see Grid::addListener), e.g. so an
+// incremental planner can repair its search instead of starting over
+class IGridListener {
+public:
+    virtual ~IGridListener() = default;
+    virtual void onCellChanged(Node cell) = 0; // Wall flag or weight of one cell changed
+    virtual void onGridReset() = 0;            // Size, connectivity or every cell changed
+    virtual void onGridDestroyed() = 0;        // The grid must not be used any more
+};
+
+// A Grid's subscribers. They follow the object, not its contents: a copy starts
+// with none, and assigning a whole grid over a subscribed one reports a reset.
+class GridListeners {
+public:
+    GridListeners() = default;
+    GridListeners(const GridListeners&) {}
+    GridListeners& operator=(const GridListeners&) {
+        reset();
+        return *this;
+    }
+    ~GridListeners() {
+        auto list = m_list; // Listeners may unsubscribe from the callback
+        for (IGridListener* l : list) l->onGridDestroyed();
+    }
+
+    void add(IGridListener* l) { if (std::find(m_list.begin(), m_list.end(), l) == m_list.end()) m_list.push_back(l); }
+    void remove(IGridListener* l) { m_list.erase(std::remove(m_list.begin(), m_list.end(), l), m_list.end()); }
+    void cellChanged(Node cell) const { for (IGridListener* l : m_list) l->onCellChanged(cell); }
+    void reset() const { for (IGridListener* l : m_list) l->onGridReset(); }
+
+private:
+    std::vector<IGridListener*> m_list;
+};
+
 class Grid : public IGraph {
 public:
     Grid(int height, int width);
@@ -18,39 +63,152 @@ public:
     void setDestination(int x, int y);
     void setWeight(int x, int y, int weight);
     void setEmpty(int x, int y);
-    void setVisited(int x, int y); 
-    void setCurrent(int x, int y); 
-    void generateRandomMaze();     
-    void clearPath(); 
-    void markPath(const std::vector<Point>& path);
+    // 30% random walls (MazeKind::Noise). seed 0 picks a fresh one; returns the seed used.
+    uint64_t generateRandomMaze(uint64_t seed = 0);
     void print() const;
     std::string serialize() const;
-    bool load(const std::string& data);
-    bool isValid(int x, int y) const;
-    bool isObstacle(int x, int y) const;
+    // Text or binary, detected from the first bytes. The grid is left untouched on failure.
+    bool load(std::string_view data, GridLoadError* error = nullptr);
+    bool load(std::istream& in, GridLoadError* error = nullptr); // Reads in chunks
+
+    // Versioned binary format (see Grid.cpp): header, obstacle bitset, then a 1- or
+    // 2-byte weight plane, run-length encoded when that is smaller.
+    std::string serializeBinary() const;
+    bool loadBinary(const char* data, size_t size, GridLoadError* error = nullptr);
+    static bool isBinaryFormat(const char* data, size_t size);
+    bool isValid(int x, int y) const { return x >= 0 && x < height && y >= 0 && y < width; }
+    bool isObstacle(int x, int y) const { return !isValid(x, y) || obstacleAt(index(x, y)); }
     int getWidth() const { return width; }
     int getHeight() const { return height; }
     Point getSource() const { return source; }
     Point getDestination() const { return destination; }
-    char getChar(int x, int y) const { return isValid(x,y) ? map[x][y] : '#'; }
-    int getWeight(int x, int y) const { return isValid(x,y) ? weights[x][y] : 9999; }
+    char getChar(int x, int y) const;
+    int getWeight(int x, int y) const { return isValid(x,y) ? weights[index(x, y)] : 9999; }
+
+    // True when every cell has weight 1, letting uniform-cost searches skip weight checks
+    bool hasUniformWeights() const { return weightedCells == 0; }
 
-    void setAllowDiagonals(bool allow) { m_allowDiagonals = allow; }
+    void setAllowDiagonals(bool allow) {
+        if (allow == m_allowDiagonals) return;
+        m_allowDiagonals = allow;
+        m_listeners.reset();
+    }
     bool getAllowDiagonals() const { return m_allowDiagonals; }
 
+    // Edits made through the setters, load() and maze generation are reported to
+    // every subscribed listener; unsubscribe before the listener dies. Subscribing
+    // does not change the grid, so it also works through a const reference
+    void addListener(IGridListener* listener) const { m_listeners.add(listener); }
+    void removeListener(IGridListener* listener) const { m_listeners.remove(listener); }
+
     // IGraph Implementation
-    std::vector<Edge> getNeighbors(Node n) const override;
+    using IGraph::getNeighbors;
+    void getNeighbors(Node n, std::vector<Edge>& neighbors) const override;
+    void getPredecessors(Node n, std::vector<Edge>& predecessors) const override;
+    int nodeCount() const override { return width * height; }
     int getHeuristic(Node start, Node target) const override;
 
+    // Inlinable, connectivity-specialized versions used by the search kernels.
+    // Neighbor order matches getNeighbors: orthogonal first, then diagonal.
+    template <bool Diagonal, typename F>
+    void forEachNeighbor(Node n, F&& visit) const {
+        static constexpr int dx[] = {-1, 1, 0, 0, -1, -1, 1, 1};
+        static constexpr int dy[] = {0, 0, -1, 1, -1, 1, -1, 1};
+        static constexpr int cost[] = {10, 10, 10, 10, 14, 14, 14, 14}; // Orthogonal 10, diagonal 14
+        constexpr int dirs = Diagonal ? 8 : 4;
+        int x = n.id / width;
+        int y = n.id % width;
+        for (int i = 0; i < dirs; ++i) {
+            int nx = x + dx[i];
+            int ny = y + dy[i];
+            if (!isValid(nx, ny)) continue;
+            int idx = index(nx, ny);
+            if (!obstacleAt(idx)) visit(Node{ idx }, cost[i] * weights[idx]);
+        }
+    }
+
+    // Reverse edges: entering n costs n's own weight, whichever neighbor we came from
+    template <bool Diagonal, typename F>
+    void forEachPredecessor(Node n, F&& visit) const {
+        static constexpr int dx[] = {-1, 1, 0, 0, -1, -1, 1, 1};
+        static constexpr int dy[] = {0, 0, -1, 1, -1, 1, -1, 1};
+        static constexpr int cost[] = {10, 10, 10, 10, 14, 14, 14, 14};
+        constexpr int dirs = Diagonal ? 8 : 4;
+        if (obstacleAt(n.id)) return; // Nothing can step onto a wall
+        int x = n.id / width;
+        int y = n.id % width;
+        int w = weights[n.id];
+        for (int i = 0; i < dirs; ++i) {
+            int nx = x + dx[i];
+            int ny = y + dy[i];
+            if (!isValid(nx, ny)) continue;
+            int idx = index(nx, ny);
+            if (!obstacleAt(idx)) visit(Node{ idx }, cost[i] * w);
+        }
+    }
+
+    template <bool Diagonal>
+    int heuristic(Node startNode, Node targetNode) const {
+        int dx = std::abs(startNode.id / width - targetNode.id / width);
+        int dy = std::abs(startNode.id % width - targetNode.id % width);
+        if (Diagonal) {
+            // Octile distance (scaled by 10)
+            return 10 * (dx + dy) + (14 - 2 * 10) * std::min(dx, dy);
+        }
+        // Manhattan distance (scaled by 10)
+        return 10 * (dx + dy);
+    }
+
     // Helpers to convert between Node and Grid coordinates
     Node toNode(int x, int y) const { return { x * width + y }; }
     Point toPoint(Node n) const { return { n.id / width, n.id % width }; }
 
+    static constexpr int MAX_WEIGHT = UINT16_MAX;
+
 private:
+    friend struct MazeGenerator; // Bulk, multi-threaded cell rewrites
+
+    // Row-major cell index, same value as toNode(x, y).id
+    int index(int x, int y) const { return x * width + y; }
+    bool obstacleAt(int i) const { return (obstacles[i >> 6] >> (i & 63)) & 1; }
+    void setObstacleBit(int i, bool on) {
+        if (on) obstacles[i >> 6] |= (uint64_t(1) << (i & 63));
+        else obstacles[i >> 6] &= ~(uint64_t(1) << (i & 63));
+    }
+    bool isEndpoint(int x, int y) const {
+        return (x == source.x && y == source.y) || (x == destination.x && y == destination.y);
+    }
+    void resize(int h, int w);
+    // Installs planes a loader has fully validated
+    void adopt(int h, int w, Point s, Point d, std::vector<uint64_t>&& bits, std::vector<uint16_t>&& cellWeights);
+    void storeWeight(int i, int weight);
+    void setCell(int i, bool wall, int weight); // Notifies when either changes
+
     int width, height;
-    std::vector<std::vector<char>> map;
-    std::vector<std::vector<int>> weights;
+    // Structure-of-arrays cell storage, all contiguous and row-major
+    std::vector<uint64_t> obstacles; // Packed obstacle bitset, one bit per cell
+    std::vector<uint16_t> weights;   // Entry cost multiplier, clamped to [1, MAX_WEIGHT]
+    int weightedCells = 0;           // Number of cells whose weight is not 1
     Point source;
     Point destination;
     bool m_allowDiagonals = false;
+    mutable GridListeners m_listeners; // Last, so an assigned grid is complete before listeners hear of it
+};
+
+// Non-virtual view of a Grid with connectivity fixed at compile time,
+// so the search kernels can inline neighbor expansion and the heuristic.
+template <bool Diagonal>
+class GridView {
+public:
+    explicit GridView(const Grid& grid) : m_grid(grid) {}
+    int nodeCount() const { return m_grid.nodeCount(); }
+    int getHeuristic(Node from, Node target) const { return m_grid.heuristic<Diagonal>(from, target); }
+    template <typename F>
+    void forEachNeighbor(Node n, F&& visit) const { m_grid.forEachNeighbor<Diagonal>(n, visit); }
+    template <typename F>
+    void forEachPredecessor(Node n, F&& visit) const { m_grid.forEachPredecessor<Diagonal>(n, visit); }
+    const Grid& grid() const { return m_grid; }
+
+private:
+    const Grid& m_grid;
 };
@@ -0,0 +1,18 @@
+#include "GridFile.h"
+#include <fstream>
+
+bool loadGridFile(Grid& grid, const GridPath& path, GridLoadError* error) {
+    MappedFile file(path);
+    if (!file.data()) {
+        if (error) *error = { 0, "cannot open or map the file" };
+        return false;
+    }
+    return grid.load(std::string_view(file.data(), file.size()), error);
+}
+
+bool saveGridFile(const Grid& grid, const GridPath& path, bool binary) {
+    std::string data = binary ? grid.serializeBinary() : grid.serialize();
+    std::ofstream out(path.c_str(), std::ios::binary);
+    out.write(data.data(), data.size());
+    return (bool)out;
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include "Grid.h"
+#include "MappedFile.h"
+#include <string>
+
+// Native file helpers for grid maps (not used by the Wasm build)
+using GridPath = FilePath;
+
+// Loads a text or binary map. The file is memory-mapped and parsed in place, without
+// an intermediate buffer. On failure error (if given) says where and why.
+bool loadGridFile(Grid& grid, const GridPath& path, GridLoadError* error = nullptr);
+
+// Writes the binary format when binary is true, otherwise the text format
+bool saveGridFile(const Grid& grid, const GridPath& path, bool binary);
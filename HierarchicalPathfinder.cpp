@@ -0,0 +1,424 @@
+#include "HierarchicalPathfinder.h"
+#include "SearchKernels.h"
+#include <atomic>
+#include <cstdlib>
+
+namespace {
+
+constexpr int INF = SearchWorkspace::INF;
+constexpr int LONG_RUN = 6; // Runs at least this long get a link at each end
+
+// Grid restricted to the clusters marked with the current stamp
+template <bool Diagonal>
+class CorridorView {
+public:
+    CorridorView(const Grid& grid, int size, int cols, const std::vector<unsigned>& marks, unsigned stamp)
+        : m_grid(grid), m_width(grid.getWidth()), m_size(size), m_cols(cols), m_marks(marks), m_stamp(stamp) {}
+    int nodeCount() const { return m_grid.nodeCount(); }
+    int getHeuristic(Node from, Node target) const { return m_grid.heuristic<Diagonal>(from, target); }
+    template <typename F>
+    void forEachNeighbor(Node n, F&& visit) const {
+        m_grid.forEachNeighbor<Diagonal>(n, [&](Node t, int w) {
+            if (m_marks[(t.id / m_width / m_size) * m_cols + t.id % m_width / m_size] == m_stamp) visit(t, w);
+        });
+    }
+
+private:
+    const Grid& m_grid;
+    int m_width, m_size, m_cols;
+    const std::vector<unsigned>& m_marks;
+    unsigned m_stamp;
+};
+
+} // namespace
+
+HierarchicalPathfinder::HierarchicalPathfinder(Grid& grid, int clusterSize, int threads)
+    : m_grid(&grid), m_size(std::max(2, clusterSize)), m_pool(threads) {
+    m_grid->addListener(this);
+}
+
+HierarchicalPathfinder::~HierarchicalPathfinder() {
+    if (m_grid) m_grid->removeListener(this);
+}
+
+int HierarchicalPathfinder::entranceCount() const {
+    int count = 0;
+    for (const Cluster& c : m_clusters) count += (int)c.nodes.size();
+    return count;
+}
+
+int HierarchicalPathfinder::crossCost(int a, int b) const {
+    bool diagonal = a / m_width != b / m_width && a % m_width != b % m_width;
+    return (diagonal ? 14 : 10) * m_grid->getWeight(b / m_width, b % m_width);
+}
+
+void HierarchicalPathfinder::onCellChanged(Node cell) {
+    if (m_stale || !m_grid || cell.id < 0 || cell.id >= (int)m_slot.size()) return;
+    const int k = clusterOf(cell.id);
+    markCluster(k);
+    // Cells on a cluster's outer ring take part in the links of up to four owners
+    int x = cell.id / m_width % m_size, y = cell.id % m_width % m_size;
+    int cx = k / m_cols, cy = k % m_cols;
+    bool ring = x == 0 || y == 0 || x == m_size - 1 || y == m_size - 1 ||
+                cell.id / m_width == m_height - 1 || cell.id % m_width == m_width - 1;
+    if (!ring) return;
+    markOwner(k);
+    if (cy > 0) markOwner(k - 1);
+    if (cx > 0) markOwner(k - m_cols);
+    if (cx > 0 && cy > 0) markOwner(k - m_cols - 1);
+}
+
+void HierarchicalPathfinder::markCluster(int k) {
+    if (m_clusterDirty[k]) return;
+    m_clusterDirty[k] = 1;
+    m_dirtyClusters.push_back(k);
+}
+
+void HierarchicalPathfinder::markOwner(int k) {
+    if (m_ownerDirty[k]) return;
+    m_ownerDirty[k] = 1;
+    m_dirtyOwners.push_back(k);
+}
+
+template <typename Work>
+void HierarchicalPathfinder::forEachParallel(const std::vector<int>& items, Work&& work) {
+    if (m_pool.threadCount() == 1 || items.size() < 4) {
+        for (int k : items) work(k, m_scratch[0]);
+        return;
+    }
+    std::atomic<size_t> next{ 0 };
+    m_pool.run([&](int self) {
+        for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < items.size();) work(items[i], m_scratch[self]);
+    });
+}
+
+void HierarchicalPathfinder::build() {
+    if (!m_grid) return;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    m_width = m_grid->getWidth();
+    m_height = m_grid->getHeight();
+    m_diagonal = m_grid->getAllowDiagonals();
+    m_rows = (m_height + m_size - 1) / m_size;
+    m_cols = (m_width + m_size - 1) / m_size;
+    const int count = m_rows * m_cols;
+    m_clusters.assign(count, Cluster());
+    m_links.assign(count, {});
+    m_slot.assign(m_grid->nodeCount(), -1);
+    m_clusterDirty.assign(count, 0);
+    m_ownerDirty.assign(count, 0);
+    m_dirtyClusters.clear();
+    m_dirtyOwners.clear();
+    m_corridor.assign(count, 0);
+    m_corridorStamp = 0;
+    m_scratch.resize(m_pool.threadCount());
+    for (Scratch& s : m_scratch) {
+        s.dist.assign(m_size * m_size, INF);
+        s.parent.assign(m_size * m_size, -1);
+    }
+
+    std::vector<int> all(count);
+    for (int k = 0; k < count; ++k) all[k] = k;
+    forEachParallel(all, [&](int k, Scratch&) { buildLinks(k); });
+    forEachParallel(all, [&](int k, Scratch& s) { buildCluster(k, s); });
+    m_stale = false;
+    m_rebuilt = count;
+    m_buildMs = m_updateMs = elapsedMs(startTime);
+}
+
+void HierarchicalPathfinder::update() {
+    if (!m_grid) return;
+    if (m_stale) {
+        build();
+        return;
+    }
+    if (m_dirtyClusters.empty() && m_dirtyOwners.empty()) return;
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Links first: an owner whose links moved changes the nodes of every cluster around its corner
+    std::vector<char> moved(m_clusters.size(), 0);
+    forEachParallel(m_dirtyOwners, [&](int k, Scratch&) { moved[k] = buildLinks(k); });
+    for (int k : m_dirtyOwners) {
+        m_ownerDirty[k] = 0;
+        if (!moved[k]) continue;
+        bool right = k % m_cols + 1 < m_cols, below = k / m_cols + 1 < m_rows;
+        markCluster(k);
+        if (right) markCluster(k + 1);
+        if (below) markCluster(k + m_cols);
+        if (right && below) markCluster(k + m_cols + 1);
+    }
+    m_dirtyOwners.clear();
+
+    forEachParallel(m_dirtyClusters, [&](int k, Scratch& s) { buildCluster(k, s); });
+    for (int k : m_dirtyClusters) m_clusterDirty[k] = 0;
+    m_rebuilt = (int)m_dirtyClusters.size();
+    m_dirtyClusters.clear();
+    m_updateMs = elapsedMs(startTime);
+}
+
+bool HierarchicalPathfinder::buildLinks(int k) {
+    const Grid& grid = *m_grid;
+    const int x0 = k / m_cols * m_size, y0 = k % m_cols * m_size;
+    const int x1 = std::min(x0 + m_size, m_height), y1 = std::min(y0 + m_size, m_width);
+    auto open = [&](int x, int y) { return !grid.isObstacle(x, y); }; // Also false off the grid
+    std::vector<std::pair<int, int>> links;
+    auto link = [&](int ax, int ay, int bx, int by) { links.push_back({ ax * m_width + ay, bx * m_width + by }); };
+
+    // Border starting at (x, y), running along (dx, dy) for len cells, the other cluster at +(ox, oy)
+    auto border = [&](int x, int y, int dx, int dy, int len, int ox, int oy) {
+        auto straight = [&](int i) {
+            return i >= 0 && i < len && open(x + i * dx, y + i * dy) && open(x + i * dx + ox, y + i * dy + oy);
+        };
+        for (int i = 0; i < len;) {
+            if (!straight(i)) {
+                ++i;
+                continue;
+            }
+            int end = i;
+            while (straight(end + 1)) ++end;
+            if (end - i + 1 < LONG_RUN) {
+                int mid = (i + end) / 2;
+                link(x + mid * dx, y + mid * dy, x + mid * dx + ox, y + mid * dy + oy);
+            } else {
+                link(x + i * dx, y + i * dy, x + i * dx + ox, y + i * dy + oy);
+                link(x + end * dx, y + end * dy, x + end * dx + ox, y + end * dy + oy);
+            }
+            i = end + 1;
+        }
+        if (!m_diagonal) return;
+        // A diagonal crossing next to a straight pair is reachable through that pair's run
+        for (int i = 0; i + 1 < len; ++i) {
+            if (straight(i) || straight(i + 1)) continue;
+            int ax = x + i * dx, ay = y + i * dy, bx = ax + dx, by = ay + dy;
+            if (open(ax, ay) && open(bx + ox, by + oy)) link(ax, ay, bx + ox, by + oy);
+            if (open(bx, by) && open(ax + ox, ay + oy)) link(bx, by, ax + ox, ay + oy);
+        }
+    };
+    if (x1 < m_height) border(x1 - 1, y0, 0, 1, y1 - y0, 1, 0);
+    if (y1 < m_width) border(x0, y1 - 1, 1, 0, x1 - x0, 0, 1);
+    // Corner crossings, needed only when both cells beside the diagonal are walls
+    if (m_diagonal && x1 < m_height && y1 < m_width) {
+        if (!open(x1 - 1, y1) && !open(x1, y1 - 1) && open(x1 - 1, y1 - 1) && open(x1, y1)) link(x1 - 1, y1 - 1, x1, y1);
+        if (!open(x1 - 1, y1 - 1) && !open(x1, y1) && open(x1 - 1, y1) && open(x1, y1 - 1)) link(x1 - 1, y1, x1, y1 - 1);
+    }
+
+    if (links == m_links[k]) return false;
+    m_links[k] = std::move(links);
+    return true;
+}
+
+void HierarchicalPathfinder::buildCluster(int k, Scratch& s) {
+    Cluster& c = m_clusters[k];
+    for (int v : c.nodes) m_slot[v] = -1;
+
+    // Links touching k are owned by k and the three clusters above and to the left
+    std::vector<std::pair<int, int>> ends; // (inside, outside)
+    const int cx = k / m_cols, cy = k % m_cols;
+    for (int ox = std::max(cx - 1, 0); ox <= cx; ++ox) {
+        for (int oy = std::max(cy - 1, 0); oy <= cy; ++oy) {
+            for (auto [a, b] : m_links[ox * m_cols + oy]) {
+                if (clusterOf(a) == k) ends.push_back({ a, b });
+                else if (clusterOf(b) == k) ends.push_back({ b, a });
+            }
+        }
+    }
+    std::sort(ends.begin(), ends.end());
+    c.nodes.clear();
+    c.exits.clear();
+    c.exitFirst.assign(1, 0);
+    for (auto [inside, outside] : ends) {
+        if (c.nodes.empty() || c.nodes.back() != inside) {
+            m_slot[inside] = (int)c.nodes.size();
+            c.nodes.push_back(inside);
+            c.exitFirst.push_back(c.exitFirst.back());
+        }
+        c.exits.push_back(outside);
+        c.exitFirst.back()++;
+    }
+
+    const int m = (int)c.nodes.size();
+    c.dist.assign((size_t)m * m, INF);
+    for (int i = 0; i < m; ++i) {
+        searchCluster(k, c.nodes[i], false, -1, s);
+        for (int j = 0; j < m; ++j) c.dist[(size_t)i * m + j] = s.dist[localIndex(k, c.nodes[j])];
+    }
+}
+
+template <bool Diagonal>
+int HierarchicalPathfinder::searchCluster(int k, int source, bool backward, int target, Scratch& s) const {
+    const Grid& grid = *m_grid;
+    const int x0 = k / m_cols * m_size, y0 = k % m_cols * m_size;
+    const int x1 = std::min(x0 + m_size, m_height), y1 = std::min(y0 + m_size, m_width);
+    std::fill(s.dist.begin(), s.dist.end(), INF);
+    s.queue.reset(0);
+    s.dist[localIndex(k, source)] = 0;
+    s.parent[localIndex(k, source)] = -1;
+    s.queue.push(Node{ source }, 0);
+
+    int settled = 0;
+    while (!s.queue.empty()) {
+        auto [d, v] = s.queue.pop();
+        if (d > s.dist[localIndex(k, v.id)]) continue;
+        settled++;
+        if (v.id == target) break;
+        auto relax = [&](Node u, int w) {
+            int x = u.id / m_width, y = u.id % m_width;
+            if (x < x0 || x >= x1 || y < y0 || y >= y1) return;
+            int local = (x - x0) * m_size + y - y0;
+            if (d + w < s.dist[local]) {
+                s.dist[local] = d + w;
+                s.parent[local] = v.id;
+                s.queue.push(u, d + w);
+            }
+        };
+        if (backward) grid.forEachPredecessor<Diagonal>(v, relax);
+        else grid.forEachNeighbor<Diagonal>(v, relax);
+    }
+    return settled;
+}
+
+int HierarchicalPathfinder::searchCluster(int k, int source, bool backward, int target, Scratch& s) const {
+    return m_diagonal ? searchCluster<true>(k, source, backward, target, s)
+                      : searchCluster<false>(k, source, backward, target, s);
+}
+
+AlgoResult HierarchicalPathfinder::query(Node start, Node goal, bool smooth, IAlgorithmObserver* observer) {
+    update();
+    auto startTime = std::chrono::high_resolution_clock::now();
+    AlgoResult res = { {}, 0, 0, 0, false };
+    if (!m_grid || start.id < 0 || start.id >= (int)m_slot.size() || goal.id < 0 || goal.id >= (int)m_slot.size()) {
+        res.timeMs = elapsedMs(startTime);
+        return res;
+    }
+    res = dispatchObserver(observer, [&](const auto& sink) {
+        return m_diagonal ? search<true>(start, goal, smooth, sink) : search<false>(start, goal, smooth, sink);
+    });
+    res.timeMs = elapsedMs(startTime);
+    return res;
+}
+
+template <bool Diagonal, typename Sink>
+AlgoResult HierarchicalPathfinder::search(Node start, Node goal, bool smooth, const Sink& sink) {
+    const Grid& grid = *m_grid;
+    AlgoResult res = { {}, 0, 0, 0, false };
+    Scratch& s = m_scratch[0];
+    const int goalCluster = clusterOf(goal.id);
+
+    // Connect the start to the link cells of its cluster (and to the goal if they share it),
+    // and every link cell of the goal's cluster to the goal
+    sink.log("HPA*: connecting start and goal...");
+    m_startEdges.clear();
+    auto connect = [&](int via, int step) {
+        const int k = clusterOf(via);
+        res.visitedCount += searchCluster<Diagonal>(k, via, false, -1, s);
+        auto add = [&](int v) {
+            int d = s.dist[localIndex(k, v)];
+            if (d == INF || v == start.id) return;
+            for (StartEdge& e : m_startEdges) {
+                if (e.cell == v) {
+                    if (step + d < e.cost) e = { v, step + d, via };
+                    return;
+                }
+            }
+            m_startEdges.push_back({ v, step + d, via });
+        };
+        for (int v : m_clusters[k].nodes) add(v);
+        if (k == goalCluster) add(goal.id);
+    };
+    if (grid.isObstacle(start.id / m_width, start.id % m_width)) {
+        grid.forEachNeighbor<Diagonal>(start, [&](Node v, int w) { connect(v.id, w); });
+    } else {
+        connect(start.id, 0);
+    }
+    const Cluster& last = m_clusters[goalCluster];
+    res.visitedCount += searchCluster<Diagonal>(goalCluster, goal.id, true, -1, s);
+    m_toGoal.resize(last.nodes.size());
+    for (size_t i = 0; i < last.nodes.size(); ++i) m_toGoal[i] = s.dist[localIndex(goalCluster, last.nodes[i])];
+
+    // A* over link cells; abstract edges cost at least the octile distance, so it stays consistent
+    sink.log("HPA*: searching the abstract graph...");
+    const int n = grid.nodeCount();
+    m_ws.reset(n);
+    m_queue.reset(n);
+    m_ws.set(start.id, 0, -1);
+    m_queue.push(start, grid.heuristic<Diagonal>(start, goal));
+    bool found = false;
+    while (!m_queue.empty()) {
+        auto [f, u] = m_queue.pop();
+        int g = m_ws.dist(u.id);
+        if (f > g + grid.heuristic<Diagonal>(u, goal)) continue;
+        res.visitedCount++;
+        sink.visited(u);
+        if (u == goal) {
+            found = true;
+            break;
+        }
+        auto relax = [&](int v, int w) {
+            if (w == INF || g + w >= m_ws.dist(v)) return;
+            m_ws.set(v, g + w, u.id);
+            m_queue.push(Node{ v }, g + w + grid.heuristic<Diagonal>(Node{ v }, goal));
+        };
+        if (u == start) {
+            for (const StartEdge& e : m_startEdges) relax(e.cell, e.cost);
+        }
+        int i = m_slot[u.id];
+        if (i < 0) continue;
+        const int k = clusterOf(u.id);
+        const Cluster& c = m_clusters[k];
+        const int m = (int)c.nodes.size();
+        for (int j = 0; j < m; ++j) {
+            if (j != i) relax(c.nodes[j], c.dist[(size_t)i * m + j]);
+        }
+        for (int e = c.exitFirst[i]; e < c.exitFirst[i + 1]; ++e) relax(c.exits[e], crossCost(u.id, c.exits[e]));
+        if (k == goalCluster) relax(goal.id, m_toGoal[i]);
+    }
+    if (!found) {
+        sink.log("Failure: No path could be found to target.");
+        return res;
+    }
+
+    // Refine: border crossings are single steps, everything else a search inside one cluster
+    std::vector<Node> abstractPath = reconstructPath(m_ws, start, goal);
+    res.totalCost = m_ws.dist(goal.id);
+    res.path.push_back(start);
+    for (size_t i = 1; i < abstractPath.size(); ++i) {
+        int a = abstractPath[i - 1].id, b = abstractPath[i].id;
+        if (i == 1) { // A start on a wall first steps to the neighbour its edge went through
+            for (const StartEdge& e : m_startEdges) {
+                if (e.cell == b && e.cost == m_ws.dist(b) && e.via != a) {
+                    a = e.via;
+                    res.path.push_back(Node{ a });
+                    break;
+                }
+            }
+        }
+        const int k = clusterOf(a);
+        if (a == b) continue;
+        if (k != clusterOf(b)) {
+            res.path.push_back(Node{ b });
+            continue;
+        }
+        res.visitedCount += searchCluster<Diagonal>(k, a, false, b, s);
+        size_t mark = res.path.size();
+        for (int v = b; v != a; v = s.parent[localIndex(k, v)]) res.path.push_back(Node{ v });
+        std::reverse(res.path.begin() + mark, res.path.end());
+    }
+    res.success = true;
+
+    if (smooth) {
+        sink.log("HPA*: smoothing within the path's clusters...");
+        if (++m_corridorStamp == 0) {
+            std::fill(m_corridor.begin(), m_corridor.end(), 0u);
+            m_corridorStamp = 1;
+        }
+        for (Node v : res.path) m_corridor[clusterOf(v.id)] = m_corridorStamp;
+        CorridorView<Diagonal> corridor(grid, m_size, m_cols, m_corridor, m_corridorStamp);
+        AlgoResult direct = aStarSearch(corridor, start, goal, NoObserver(), m_ws, m_queue);
+        res.visitedCount += direct.visitedCount;
+        if (direct.success && direct.totalCost <= res.totalCost) {
+            res.path = std::move(direct.path);
+            res.totalCost = direct.totalCost;
+        }
+    }
+    sink.log("Path reconstruction complete.");
+    return res;
+}
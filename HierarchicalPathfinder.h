@@ -0,0 +1,116 @@
+#pragma once
+#include "Algorithms.h"
+#include "Grid.h"
+#include "PriorityQueues.h"
+#include "SearchWorkspace.h"
+#include "WorkerPool.h"
+#include <utility>
+#include <vector>
+
+// Approximate routing for large grids (HPA*, Botea, Müller & Schaeffer). The grid
+// is cut into square clusters; each border between two clusters gets one link per
+// run of cells open on both sides (two, at its ends, for runs of 6 or more), plus
+// on 8-connected grids the diagonal and corner crossings no straight link covers,
+// so every path A* finds has an abstract counterpart. Inside a cluster the costs
+// between its link cells are precomputed. A query connects start and goal to their
+// clusters, runs A* over link cells only, then refines each abstract edge with a
+// search confined to one cluster. Optional smoothing re-runs A* restricted to the
+// clusters the path crosses, which removes most detours through link cells.
+//
+// Paths are valid and succeed exactly when runAStar does, but may cost more. The
+// abstraction is built on first use (in parallel, one cluster per task) and then
+// follows the grid's edits: a changed cell rebuilds its cluster, and its neighbours
+// only when the links along their shared border moved. totalCost is the returned
+// path's cost; visitedCount counts abstract and local expansions; timeMs excludes
+// bringing the abstraction up to date (see lastUpdateMs()).
+// Not thread-safe: edits must not race with query().
+class HierarchicalPathfinder : public IGridListener {
+public:
+    // threads = 0: hardware concurrency; use 1 in a Wasm build without pthreads
+    explicit HierarchicalPathfinder(Grid& grid, int clusterSize = 16, int threads = 0);
+    ~HierarchicalPathfinder() override;
+    HierarchicalPathfinder(const HierarchicalPathfinder&) = delete;
+    HierarchicalPathfinder& operator=(const HierarchicalPathfinder&) = delete;
+
+    AlgoResult query(Node start, Node goal, bool smooth = false, IAlgorithmObserver* observer = nullptr);
+
+    void build();  // Rebuilds every cluster now
+    void update(); // Rebuilds what pending edits touched (all of it after a reset)
+
+    int clusterSize() const { return m_size; }
+    int clusterCount() const { return (int)m_clusters.size(); }
+    int entranceCount() const;
+    double buildMs() const { return m_buildMs; }
+    double lastUpdateMs() const { return m_updateMs; }
+    int lastRebuiltClusters() const { return m_rebuilt; }
+    // False once the grid has been destroyed; query() then fails
+    bool attached() const { return m_grid != nullptr; }
+
+    void onCellChanged(Node cell) override;
+    void onGridReset() override { m_stale = true; }
+    void onGridDestroyed() override { m_grid = nullptr; }
+
+private:
+    struct Cluster {
+        std::vector<int> nodes;     // Link cells inside the cluster, ascending
+        std::vector<int> exitFirst; // CSR over nodes into exits
+        std::vector<int> exits;     // Cells across the border each node links to
+        std::vector<int> dist;      // nodes x nodes, cost without leaving the cluster, INF if none
+    };
+    // Per-thread state for searches confined to one cluster, indexed by local cell
+    struct Scratch {
+        std::vector<int> dist, parent;
+        BinaryHeapQueue queue;
+    };
+
+    int clusterOf(int cell) const { return (cell / m_width / m_size) * m_cols + cell % m_width / m_size; }
+    int localIndex(int k, int cell) const {
+        return (cell / m_width - k / m_cols * m_size) * m_size + cell % m_width - k % m_cols * m_size;
+    }
+    // Entering b from the adjacent cell a
+    int crossCost(int a, int b) const;
+
+    void markCluster(int k);
+    void markOwner(int k);
+    bool buildLinks(int k); // Links of the borders k owns (below, right, lower-right corner); true if they changed
+    void buildCluster(int k, Scratch& s);
+    template <typename Work>
+    void forEachParallel(const std::vector<int>& items, Work&& work);
+
+    // Dijkstra from source (over incoming edges if backward) that never leaves cluster k,
+    // stopping once target (if any) is settled. Returns the settled count.
+    template <bool Diagonal>
+    int searchCluster(int k, int source, bool backward, int target, Scratch& s) const;
+    int searchCluster(int k, int source, bool backward, int target, Scratch& s) const;
+    template <bool Diagonal, typename Sink>
+    AlgoResult search(Node start, Node goal, bool smooth, const Sink& sink);
+
+    Grid* m_grid;
+    int m_size;
+    int m_width = 0, m_height = 0, m_rows = 0, m_cols = 0;
+    bool m_diagonal = false;
+    bool m_stale = true; // Next update() rebuilds everything
+
+    std::vector<Cluster> m_clusters;
+    std::vector<std::vector<std::pair<int, int>>> m_links; // Per owning cluster, as cell pairs
+    std::vector<int> m_slot; // Per cell: index in its cluster's nodes, -1 if none
+    std::vector<int> m_dirtyClusters, m_dirtyOwners;
+    std::vector<char> m_clusterDirty, m_ownerDirty;
+
+    WorkerPool m_pool;
+    std::vector<Scratch> m_scratch; // One per worker
+    SearchWorkspace m_ws;
+    BinaryHeapQueue m_queue;
+    // Abstract edges out of the start, each through the cell it starts from: the start
+    // itself, or for a start on a wall (which can only be left) each neighbour
+    struct StartEdge {
+        int cell, cost, via;
+    };
+    std::vector<StartEdge> m_startEdges;
+    std::vector<int> m_toGoal; // Per node of the goal's cluster
+    std::vector<unsigned> m_corridor;
+    unsigned m_corridorStamp = 0;
+
+    double m_buildMs = 0, m_updateMs = 0;
+    int m_rebuilt = 0;
+};
@@ -21,14 +21,36 @@ struct Edge {
 class IGraph {
 public:
     virtual ~IGraph() = default;
-    virtual std::vector<Edge> getNeighbors(Node n) const = 0;
+    // Fills a caller-owned buffer (cleared first). Reusing the same buffer across
+    // expansions keeps its capacity, so the search loop performs no allocations.
+    virtual void getNeighbors(Node n, std::vector<Edge>& out) const = 0;
+    // Compatibility shim: allocates a fresh vector per call
+    std::vector<Edge> getNeighbors(Node n) const {
+        std::vector<Edge> out;
+        getNeighbors(n, out);
+        return out;
+    }
+    // Incoming edges of n (edge.target is the predecessor), used by backward searches.
+    // The default assumes a symmetric graph; override when edge costs are directional.
+    virtual void getPredecessors(Node n, std::vector<Edge>& out) const { getNeighbors(n, out); }
+    virtual int nodeCount() const = 0; // Node ids are dense in [0, nodeCount())
     virtual int getHeuristic(Node start, Node target) const { return 0; } // Optional for A*
 };
 
 // Interface for observing algorithm progress (Visualization)
 class IAlgorithmObserver {
 public:
+    // Events an observer wants; the kernels skip the work for everything else
+    // (log messages are only formatted when LOG is requested).
+    enum Capability : unsigned {
+        VISITED = 1 << 0,
+        CURRENT = 1 << 1,
+        LOG = 1 << 2,
+        ALL = VISITED | CURRENT | LOG
+    };
+
     virtual ~IAlgorithmObserver() = default;
+    virtual unsigned capabilities() const { return ALL; }
     virtual void onNodeVisited(Node n) = 0;
     virtual void onNodeCurrent(Node n) = 0;
     virtual void onLog(const std::string& msg) = 0;
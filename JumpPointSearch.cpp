@@ -0,0 +1,227 @@
+#include "JumpPointSearch.h"
+#include "SearchKernels.h"
+
+namespace {
+
+inline int sign(int v) { return (v > 0) - (v < 0); }
+
+// Jump and pruning rules over a Grid. Diagonal moves may cut corners, matching
+// Grid::getNeighbors, so the 8-connected rules are the "always move diagonally"
+// variant; the 4-connected rules scan along y and branch along x.
+template <bool Diagonal>
+class JumpPointGrid {
+public:
+    JumpPointGrid(const Grid& grid, Node goal)
+        : m_grid(grid), m_width(grid.getWidth()), m_goal(goal.id), m_uniform(grid.hasUniformWeights()) {}
+
+    bool walkable(int x, int y) const { return !m_grid.isObstacle(x, y); }
+
+    // A cell where pruning is unsafe: something in its 3x3 block costs more than 1 to enter
+    bool irregular(int x, int y) const {
+        if (m_uniform) return false;
+        for (int i = x - 1; i <= x + 1; ++i) {
+            for (int j = y - 1; j <= y + 1; ++j) {
+                if (walkable(i, j) && m_grid.getWeight(i, j) != 1) return true;
+            }
+        }
+        return false;
+    }
+
+    // Jumps from (x, y), the first cell entered, along (dx, dy); returns the jump point id or -1
+    int jump(int x, int y, int dx, int dy) const {
+        if (dx != 0 && dy != 0) return jumpDiagonal(x, y, dx, dy);
+        return jumpStraight(x, y, dx, dy);
+    }
+
+    // Calls visit(dx, dy) for each direction worth jumping in from (x, y)
+    template <typename F>
+    void forEachDirection(int x, int y, int px, int py, F&& visit) const {
+        static constexpr int dirX[] = {-1, 1, 0, 0, -1, -1, 1, 1};
+        static constexpr int dirY[] = {0, 0, -1, 1, -1, 1, -1, 1};
+        constexpr int dirs = Diagonal ? 8 : 4;
+
+        if (px < 0 || irregular(x, y)) {
+            for (int i = 0; i < dirs; ++i) {
+                if (walkable(x + dirX[i], y + dirY[i])) visit(dirX[i], dirY[i]);
+            }
+            return;
+        }
+
+        int dx = sign(x - px);
+        int dy = sign(y - py);
+        auto tryDir = [&](int ddx, int ddy) {
+            if (walkable(x + ddx, y + ddy)) visit(ddx, ddy);
+        };
+
+        if (Diagonal) {
+            if (dx != 0 && dy != 0) {
+                tryDir(0, dy);
+                tryDir(dx, 0);
+                tryDir(dx, dy);
+                if (!walkable(x - dx, y)) tryDir(-dx, dy);
+                if (!walkable(x, y - dy)) tryDir(dx, -dy);
+            } else if (dx == 0) {
+                tryDir(0, dy);
+                if (!walkable(x + 1, y)) tryDir(1, dy);
+                if (!walkable(x - 1, y)) tryDir(-1, dy);
+            } else {
+                tryDir(dx, 0);
+                if (!walkable(x, y + 1)) tryDir(dx, 1);
+                if (!walkable(x, y - 1)) tryDir(dx, -1);
+            }
+        } else {
+            if (dx != 0) {
+                tryDir(0, -1);
+                tryDir(0, 1);
+                tryDir(dx, 0);
+            } else {
+                tryDir(-1, 0);
+                tryDir(1, 0);
+                tryDir(0, dy);
+            }
+        }
+    }
+
+    // Cost of the straight or diagonal segment from `from` to jump point `to`:
+    // every cell before `to` has weight 1, `to` is charged its own weight.
+    int segmentCost(int from, int to) const {
+        int fx = from / m_width, fy = from % m_width;
+        int tx = to / m_width, ty = to % m_width;
+        int steps = std::max(std::abs(tx - fx), std::abs(ty - fy));
+        int unit = (tx != fx && ty != fy) ? 14 : 10;
+        return (steps - 1) * unit + unit * m_grid.getWeight(tx, ty);
+    }
+
+private:
+    bool stopsHere(int x, int y) const { return x * m_width + y == m_goal || irregular(x, y); }
+
+    int jumpStraight(int x, int y, int dx, int dy) const {
+        while (true) {
+            if (!walkable(x, y)) return -1;
+            if (stopsHere(x, y)) return x * m_width + y;
+            if (Diagonal) {
+                if (dx != 0) {
+                    if ((walkable(x + dx, y + 1) && !walkable(x, y + 1)) ||
+                        (walkable(x + dx, y - 1) && !walkable(x, y - 1))) return x * m_width + y;
+                } else {
+                    if ((walkable(x + 1, y + dy) && !walkable(x + 1, y)) ||
+                        (walkable(x - 1, y + dy) && !walkable(x - 1, y))) return x * m_width + y;
+                }
+            } else {
+                if (dx != 0) {
+                    if ((walkable(x, y - 1) && !walkable(x - dx, y - 1)) ||
+                        (walkable(x, y + 1) && !walkable(x - dx, y + 1))) return x * m_width + y;
+                } else {
+                    if ((walkable(x - 1, y) && !walkable(x - 1, y - dy)) ||
+                        (walkable(x + 1, y) && !walkable(x + 1, y - dy))) return x * m_width + y;
+                    // Moving along y, a jump point reachable along x makes this cell one too
+                    if (jumpStraight(x + 1, y, 1, 0) != -1 || jumpStraight(x - 1, y, -1, 0) != -1) return x * m_width + y;
+                }
+            }
+            x += dx;
+            y += dy;
+        }
+    }
+
+    int jumpDiagonal(int x, int y, int dx, int dy) const {
+        while (true) {
+            if (!walkable(x, y)) return -1;
+            if (stopsHere(x, y)) return x * m_width + y;
+            if ((walkable(x - dx, y + dy) && !walkable(x - dx, y)) ||
+                (walkable(x + dx, y - dy) && !walkable(x, y - dy))) return x * m_width + y;
+            if (jumpStraight(x + dx, y, dx, 0) != -1 || jumpStraight(x, y + dy, 0, dy) != -1) return x * m_width + y;
+            x += dx;
+            y += dy;
+        }
+    }
+
+    const Grid& m_grid;
+    int m_width;
+    int m_goal;
+    bool m_uniform;
+};
+
+template <typename Queue, bool Diagonal, typename Observer>
+AlgoResult jpsSearch(const Grid& grid, Node start, Node end, const Observer& observer) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    AlgoResult res = { {}, 0, 0, 0, false };
+
+    JumpPointGrid<Diagonal> jp(grid, end);
+    const int width = grid.getWidth();
+
+    SearchWorkspace ws; // dist holds gScore, parent the previous jump point
+    ws.reset(grid.nodeCount());
+    Queue pq;
+    pq.reset(grid.nodeCount());
+
+    ws.set(start.id, 0, -1);
+    pq.push(start, grid.heuristic<Diagonal>(start, end));
+
+    observer.log("Core: Starting Jump Point Search...");
+
+    while (!pq.empty()) {
+        auto [f, curr] = pq.pop();
+
+        int currG = ws.dist(curr.id);
+        if (f > currG + grid.heuristic<Diagonal>(curr, end)) continue; // Stale duplicate
+
+        res.visitedCount++;
+        observer.visited(curr);
+
+        if (curr == end) {
+            res.success = true;
+            break;
+        }
+
+        int x = curr.id / width, y = curr.id % width;
+        int parent = ws.parent(curr.id);
+        int px = parent < 0 ? -1 : parent / width;
+        int py = parent < 0 ? -1 : parent % width;
+        jp.forEachDirection(x, y, px, py, [&](int dx, int dy) {
+            int next = jp.jump(x + dx, y + dy, dx, dy);
+            if (next == -1) return;
+            int tentative_gScore = currG + jp.segmentCost(curr.id, next);
+            if (tentative_gScore < ws.dist(next)) {
+                ws.set(next, tentative_gScore, curr.id);
+                Node target{ next };
+                pq.push(target, tentative_gScore + grid.heuristic<Diagonal>(target, end));
+                observer.logWith([&] { return "Core: Jump point " + std::to_string(next) + " gScore: " + std::to_string(tentative_gScore); });
+            }
+        });
+    }
+
+    if (res.success) {
+        // Expand jump point links back into consecutive cells
+        std::vector<Node> jumps = reconstructPath(ws, start, end);
+        res.path.push_back(start);
+        for (size_t i = 1; i < jumps.size(); ++i) {
+            int x = jumps[i - 1].id / width, y = jumps[i - 1].id % width;
+            int tx = jumps[i].id / width, ty = jumps[i].id % width;
+            int dx = sign(tx - x), dy = sign(ty - y);
+            while (x != tx || y != ty) {
+                x += dx;
+                y += dy;
+                res.path.push_back(grid.toNode(x, y));
+            }
+        }
+        res.totalCost = ws.dist(end.id);
+        observer.log("Path reconstruction complete.");
+    } else {
+        observer.log("Failure: No path could be found to target.");
+    }
+
+    res.timeMs = elapsedMs(startTime);
+    return res;
+}
+
+} // namespace
+
+AlgoResult runJPS(const Grid& grid, Node start, Node end, IAlgorithmObserver* observer, QueueKind queue) {
+    return dispatchQueue(queue, [&](auto tag) {
+        using Q = typename decltype(tag)::type;
+        return dispatchObserver(observer, [&](const auto& sink) {
+            if (grid.getAllowDiagonals()) return jpsSearch<Q, true>(grid, start, end, sink);
+            return jpsSearch<Q, false>(grid, start, end, sink);
+        });
+    });
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include "Grid.h"
+#include "Algorithms.h"
+
+// Jump Point Search on a Grid, 4- or 8-connected according to getAllowDiagonals().
+// Runs of weight-1 cells are skipped in straight and diagonal jumps; any cell whose
+// 3x3 neighborhood holds a non-unit weight stops a jump and is expanded like
+// ordinary A*, so the result stays optimal under getWeight. The path in the
+// result is the full cell sequence, visitedCount counts expanded jump points.
+AlgoResult runJPS(const Grid& grid, Node start, Node end, IAlgorithmObserver* observer = nullptr, QueueKind queue = QueueKind::BinaryHeap);
@@ -0,0 +1,326 @@
+#include "Landmarks.h"
+#include "DistanceField.h"
+#include "Random.h"
+#include "SearchKernels.h"
+#include <climits>
+#include <functional>
+#include <numeric>
+#include <queue>
+
+namespace {
+
+constexpr uint32_t UNKNOWN = UINT32_MAX;
+constexpr int MAX_LANDMARKS = 64;
+
+} // namespace
+
+LandmarkGraph::LandmarkGraph(const IGraph& base) : m_base(base), m_grid(dynamic_cast<const Grid*>(&base)) {
+    if (m_grid) m_grid->addListener(this);
+}
+
+LandmarkGraph::~LandmarkGraph() {
+    if (m_grid) m_grid->removeListener(this);
+}
+
+void LandmarkGraph::build(int count, LandmarkSelection selection, uint64_t seed) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    m_count = std::max(1, std::min(count, MAX_LANDMARKS));
+    m_selection = selection;
+    m_seed = seed;
+    resetTables();
+    for (int i = 0; i < m_count; ++i) {
+        Node next = selection == LandmarkSelection::Avoid ? avoidLandmark(i) : farthestLandmark(i);
+        if (next.id < 0) break; // Graph without edges
+        addLandmark(next);
+    }
+    narrow();
+    clearPending(); // The tables now reflect every edit so far
+    m_buildMs = elapsedMs(startTime);
+}
+
+void LandmarkGraph::resetTables() {
+    m_landmarks.clear();
+    m_rows = m_base.nodeCount();
+    m_stride = 2 * m_count;
+    m_wide = true;
+    m_unit = 1;
+    m_table.assign((size_t)m_rows * m_stride, UNKNOWN);
+    std::vector<uint16_t>().swap(m_narrow);
+}
+
+void LandmarkGraph::addLandmark(Node landmark) {
+    const int column = 2 * (int)m_landmarks.size();
+    m_landmarks.push_back(landmark);
+    DistanceField field;
+    computeDistanceField(m_base, { landmark }, field, FieldMode::FromSources);
+    for (int v = 0; v < m_rows; ++v) {
+        if (field.dist[v] >= 0) m_table[(size_t)v * m_stride + column] = field.dist[v];
+    }
+    computeDistanceField(m_base, { landmark }, field, FieldMode::ToSources);
+    for (int v = 0; v < m_rows; ++v) {
+        if (field.dist[v] >= 0) m_table[(size_t)v * m_stride + column + 1] = field.dist[v];
+    }
+}
+
+void LandmarkGraph::narrow() {
+    uint32_t largest = 0, unit = 0;
+    for (uint32_t d : m_table) {
+        if (d != UNKNOWN) {
+            largest = std::max(largest, d);
+            unit = std::gcd(unit, d);
+        }
+    }
+    unit = std::max(unit, 1u);
+    if (largest / unit >= UINT16_MAX) return;
+    m_unit = (int)unit;
+    m_narrow.resize(m_table.size());
+    for (size_t i = 0; i < m_table.size(); ++i) m_narrow[i] = m_table[i] == UNKNOWN ? UINT16_MAX : (uint16_t)(m_table[i] / unit);
+    std::vector<uint32_t>().swap(m_table);
+    m_wide = false;
+}
+
+// Walls and other nodes nothing can enter make useless landmarks (every
+// distance to them is unknown), so only nodes with incoming edges qualify
+Node LandmarkGraph::randomNode(uint64_t salt) const {
+    if (m_rows == 0) return Node{ -1 };
+    Rng rng(mix64(m_seed ^ salt));
+    int offset = rng.below(m_rows);
+    std::vector<Edge> edges;
+    for (int i = 0; i < m_rows; ++i) {
+        Node v{ (offset + i) % m_rows };
+        m_base.getPredecessors(v, edges);
+        if (!edges.empty()) return v;
+    }
+    return Node{ -1 };
+}
+
+Node LandmarkGraph::farthestLandmark(uint64_t salt) const {
+    std::vector<Node> sources = m_landmarks;
+    if (sources.empty()) {
+        Node root = randomNode(salt);
+        if (root.id < 0) return root;
+        sources.push_back(root);
+    }
+    DistanceField field;
+    computeDistanceField(m_base, sources, field, FieldMode::FromSources);
+
+    // A component no landmark reaches yet counts as infinitely far
+    Rng rng(mix64(m_seed ^ salt) + 1);
+    int offset = rng.below(m_rows);
+    std::vector<Edge> edges;
+    Node farthest{ -1 };
+    int farthestDist = -1;
+    for (int i = 0; i < m_rows; ++i) {
+        int v = (offset + i) % m_rows;
+        if (field.dist[v] < 0) {
+            m_base.getPredecessors(Node{ v }, edges);
+            if (!edges.empty()) return Node{ v };
+        } else if (field.dist[v] > farthestDist) {
+            farthestDist = field.dist[v];
+            farthest = Node{ v };
+        }
+    }
+    return farthest;
+}
+
+// Goldberg & Harrelson's "avoid": in a shortest-path tree from a random root, weigh
+// each node by how far the current bound on d(root, v) falls short, sum the weights
+// over subtrees that hold no landmark, then walk from the heaviest such subtree down
+// its heaviest children to a leaf
+Node LandmarkGraph::avoidLandmark(uint64_t salt) const {
+    Node root = randomNode(salt);
+    if (root.id < 0) return root;
+    DistanceField field;
+    computeDistanceField(m_base, { root }, field, FieldMode::FromSources);
+
+    // Children of each reached node in CSR form, then a preorder from the root
+    const int n = m_rows;
+    std::vector<int> first(n + 1, 0), children;
+    for (int v = 0; v < n; ++v) {
+        if (field.parent[v] >= 0) first[field.parent[v] + 1]++;
+    }
+    for (int v = 0; v < n; ++v) first[v + 1] += first[v];
+    children.resize(first[n]);
+    std::vector<int> fill(first.begin(), first.end() - 1);
+    for (int v = 0; v < n; ++v) {
+        if (field.parent[v] >= 0) children[fill[field.parent[v]]++] = v;
+    }
+    std::vector<int> order = { root.id };
+    for (size_t i = 0; i < order.size(); ++i) {
+        int v = order[i];
+        order.insert(order.end(), children.begin() + first[v], children.begin() + first[v + 1]);
+    }
+
+    std::vector<char> covered(n, 0);
+    for (Node l : m_landmarks) covered[l.id] = 1;
+    std::vector<long long> size(n, 0);
+    for (size_t i = order.size(); i-- > 0;) {
+        int v = order[i];
+        if (covered[v]) size[v] = 0; // Children already reported whether they hold one
+        else size[v] += field.dist[v] - lowerBound(root, Node{ v });
+        int p = field.parent[v];
+        if (p >= 0) {
+            if (covered[v]) covered[p] = 1;
+            size[p] += size[v];
+        }
+    }
+
+    int best = -1;
+    for (int v : order) {
+        if (best < 0 || size[v] > size[best]) best = v;
+    }
+    if (size[best] <= 0) return farthestLandmark(salt);
+    int v = best;
+    while (first[v] < first[v + 1]) {
+        int next = children[first[v]];
+        for (int i = first[v] + 1; i < first[v + 1]; ++i) {
+            if (size[children[i]] > size[next]) next = children[i];
+        }
+        v = next;
+    }
+    return Node{ v };
+}
+
+void LandmarkGraph::refresh(const std::vector<Node>& changed) {
+    if (empty()) return;
+    if (m_rows != m_base.nodeCount()) {
+        build(m_count, m_selection, m_seed);
+        return;
+    }
+    if (m_wide) {
+        propagate(m_table, 1, changed);
+    } else if (!propagate(m_narrow, m_unit, changed)) {
+        // A distance outgrew 16 bits or the unit: refill everything with the same landmarks
+        std::vector<Node> landmarks = m_landmarks;
+        resetTables();
+        for (Node l : landmarks) addLandmark(l);
+        narrow();
+    }
+}
+
+void LandmarkGraph::onCellChanged(Node cell) {
+    if (empty()) return; // build() reads the grid as it is then
+    if ((size_t)cell.id >= m_isPending.size()) m_isPending.resize(m_base.nodeCount(), 0);
+    if (!m_isPending[cell.id]) {
+        m_isPending[cell.id] = 1;
+        m_pending.push_back(cell);
+    }
+    m_pendingEdits.store(true, std::memory_order_release);
+}
+
+void LandmarkGraph::onGridReset() {
+    if (empty()) return;
+    m_pendingReset = true;
+    m_pendingEdits.store(true, std::memory_order_release);
+}
+
+void LandmarkGraph::clearPending() {
+    for (Node c : m_pending) m_isPending[c.id] = 0;
+    m_pending.clear();
+    m_pendingReset = false;
+    m_pendingEdits.store(false, std::memory_order_release);
+}
+
+// Runs from const queries: the tables cache distances of the base graph, and
+// bringing them up to date does not change the graph this object presents.
+// The first query after an edit applies it; concurrent ones wait for it.
+void LandmarkGraph::applyPending() const {
+    std::lock_guard<std::mutex> lock(m_syncMutex);
+    if (!m_pendingEdits.load(std::memory_order_relaxed)) return; // Applied by another query
+    LandmarkGraph& self = const_cast<LandmarkGraph&>(*this);
+    if (m_pendingReset) self.build(m_count, m_selection, m_seed);
+    else self.refresh(m_pending);
+    self.clearPending(); // Only now, so queries that skip the lock see finished tables
+}
+
+// Decrease-only Dijkstra per column, seeded where the edits touched. The tables
+// stay feasible potentials (d(x) <= d(y) + w for every current edge y -> x), which
+// is all the triangle-inequality bounds need to remain admissible and consistent.
+template <typename T>
+bool LandmarkGraph::propagate(std::vector<T>& table, int unit, const std::vector<Node>& changed) {
+    const T unknown = (T)~T(0);
+    const long long limit = std::min<long long>(unknown, INT_MAX);
+    using Item = std::pair<long long, int>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    std::vector<Edge> edges, seeds;
+    auto at = [&](int v, int column) -> T& { return table[(size_t)v * m_stride + column]; };
+
+    for (int column = 0; column < m_stride; ++column) {
+        const bool fromLandmark = column % 2 == 0;
+        // Lowers v to the best value through its in-edges (from) or out-edges (to)
+        auto improve = [&](int v) {
+            if (fromLandmark) m_base.getPredecessors(Node{ v }, edges);
+            else m_base.getNeighbors(Node{ v }, edges);
+            long long best = at(v, column) == unknown ? LLONG_MAX : at(v, column);
+            for (const Edge& e : edges) {
+                T d = at(e.target.id, column);
+                if (d == unknown) continue;
+                if (e.weight % unit != 0) return false;
+                best = std::min(best, (long long)d + e.weight / unit);
+            }
+            if (at(v, column) != unknown && best >= at(v, column)) return true;
+            if (best == LLONG_MAX) return true;
+            if (best >= limit) return false;
+            at(v, column) = (T)best;
+            queue.push({ best, v });
+            return true;
+        };
+
+        // An edit changes the edges into the edited node: that node's distance from a
+        // landmark, and the distance to a landmark of every node with an edge into it
+        for (Node c : changed) {
+            if (c.id < 0 || c.id >= m_rows) continue;
+            if (!improve(c.id)) return false;
+            if (!fromLandmark) {
+                m_base.getPredecessors(c, seeds);
+                for (const Edge& e : seeds) {
+                    if (!improve(e.target.id)) return false;
+                }
+            }
+        }
+        while (!queue.empty()) {
+            auto [d, v] = queue.top();
+            queue.pop();
+            if (d != at(v, column)) continue;
+            if (fromLandmark) m_base.getNeighbors(Node{ v }, edges);
+            else m_base.getPredecessors(Node{ v }, edges);
+            for (const Edge& e : edges) {
+                if (e.weight % unit != 0) return false;
+                long long nd = d + e.weight / unit;
+                T& slot = at(e.target.id, column);
+                if (slot != unknown && nd >= slot) continue;
+                if (nd >= limit) return false;
+                slot = (T)nd;
+                queue.push({ nd, e.target.id });
+            }
+        }
+    }
+    return true;
+}
+
+namespace {
+
+template <typename Kernel>
+auto dispatchLandmarks(const LandmarkGraph& alt, IAlgorithmObserver* observer, Kernel&& kernel) {
+    alt.sync();
+    const Grid* grid = dynamic_cast<const Grid*>(&alt.base());
+    if (!grid || !alt.valid()) return dispatchGraph(alt, observer, kernel);
+    if (grid->getAllowDiagonals()) return dispatchView(LandmarkGridView<true>(alt, *grid), observer, kernel);
+    return dispatchView(LandmarkGridView<false>(alt, *grid), observer, kernel);
+}
+
+} // namespace
+
+AlgoResult runAStar(const LandmarkGraph& graph, Node start, Node end, IAlgorithmObserver* observer, QueueKind queue) {
+    return dispatchQueue(queue, [&](auto tag) {
+        using Q = typename decltype(tag)::type;
+        return dispatchLandmarks(graph, observer, [&](const auto& view, const auto& sink) { return aStarSearch<Q>(view, start, end, sink); });
+    });
+}
+
+AlgoResult runBiAStar(const LandmarkGraph& graph, Node start, Node end, IAlgorithmObserver* observer, QueueKind queue) {
+    return dispatchQueue(queue, [&](auto tag) {
+        using Q = typename decltype(tag)::type;
+        return dispatchLandmarks(graph, observer, [&](const auto& view, const auto& sink) { return bidirectionalSearch<Q, true>(view, start, end, sink); });
+    });
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include "Algorithms.h"
+#include "Grid.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// ALT (A*, Landmarks, Triangle inequality): a wrapper graph whose getHeuristic is
+// the best lower bound from precomputed distances to and from k landmarks,
+//   d(v, t) >= d(L, t) - d(L, v)   and   d(v, t) >= d(v, L) - d(t, L),
+// maxed with the wrapped graph's own heuristic. Both directions are stored since
+// grid edges are not symmetric (entering a cell costs its weight). Unlike the
+// octile bound it sees walls and weights, so A* on mazes and terrain expands far
+// fewer nodes. Pass the LandmarkGraph itself to runAStar / runBiAStar; over a Grid
+// the search keeps the inlined grid expansion (see LandmarkGridView).
+//
+// Tables are node-major (each node's 2k entries are adjacent) and 16-bit when
+// every finite distance fits after dividing by their common factor (10 on
+// 4-connected grids), 32-bit otherwise.
+//
+// Over a Grid the tables follow its edits: changed cells are collected as the
+// grid reports them and patched in (see refresh()) before the next bound is
+// read, and a reset (load, diagonal toggle) rebuilds them. Queries may run
+// concurrently; edits must not race with them.
+enum class LandmarkSelection {
+    Farthest, // Each landmark is the node farthest from the ones already chosen
+    Avoid     // Goldberg-Harrelson: grows a shortest-path tree from a random root and
+              // picks a leaf of its worst-covered subtree (better bounds, slower build)
+};
+
+class LandmarkGraph : public IGraph, public IGridListener {
+public:
+    // base must outlive this object. A Grid base is subscribed to; edits to any
+    // other base go through refresh()
+    explicit LandmarkGraph(const IGraph& base);
+    ~LandmarkGraph() override;
+    LandmarkGraph(const LandmarkGraph&) = delete;
+    LandmarkGraph& operator=(const LandmarkGraph&) = delete;
+
+    // Replaces any previous landmarks. count is clamped to [1, 64].
+    void build(int count, LandmarkSelection selection = LandmarkSelection::Avoid, uint64_t seed = 1);
+
+    // Brings the tables up to date after edits to the nodes in changed (a Grid base
+    // reports its edited cells itself, see sync()). Only improvements are
+    // propagated, from the edited nodes outward, so the cost follows the region whose
+    // distances dropped. Edits that make paths longer leave the old distances in place:
+    // they still bound the new ones from below, just less tightly, until the next build().
+    // A different node count (e.g. after Grid::load) triggers a full build.
+    void refresh(const std::vector<Node>& changed);
+    // Applies the edits a Grid base reported since the last call. getHeuristic and
+    // the search entry points call it; call it before using lowerBound() directly.
+    void sync() const { if (m_pendingEdits.load(std::memory_order_acquire)) applyPending(); }
+
+    bool empty() const { return m_landmarks.empty(); }
+    // Tables exist, were built for the base graph's current node count and have
+    // no reported edits left to apply
+    bool valid() const {
+        return !empty() && !m_pendingEdits.load(std::memory_order_acquire) && m_rows == m_base.nodeCount();
+    }
+    const std::vector<Node>& landmarks() const { return m_landmarks; }
+    int bytesPerEntry() const { return m_wide ? 4 : 2; }
+    size_t tableBytes() const { return m_narrow.size() * 2 + m_table.size() * 4; }
+    double buildMs() const { return m_buildMs; }
+    const IGraph& base() const { return m_base; }
+
+    // Max over landmarks of the triangle-inequality bounds on d(from, to). Requires valid().
+    int lowerBound(Node from, Node to) const {
+        return m_wide ? bound(&m_table[(size_t)from.id * m_stride], &m_table[(size_t)to.id * m_stride])
+                      : m_unit * bound(&m_narrow[(size_t)from.id * m_stride], &m_narrow[(size_t)to.id * m_stride]);
+    }
+
+    // IGraph Implementation: the base graph's edges, the sharper heuristic
+    using IGraph::getNeighbors;
+    void getNeighbors(Node n, std::vector<Edge>& out) const override { m_base.getNeighbors(n, out); }
+    void getPredecessors(Node n, std::vector<Edge>& out) const override { m_base.getPredecessors(n, out); }
+    int nodeCount() const override { return m_base.nodeCount(); }
+    int getHeuristic(Node start, Node target) const override {
+        sync();
+        int h = m_base.getHeuristic(start, target);
+        return valid() ? std::max(h, lowerBound(start, target)) : h;
+    }
+
+    void onCellChanged(Node cell) override;
+    void onGridReset() override;
+    void onGridDestroyed() override { m_grid = nullptr; }
+
+private:
+    // Entries at each node: [2i] = d(landmark i, node), [2i + 1] = d(node, landmark i)
+    template <typename T>
+    int bound(const T* v, const T* t) const {
+        constexpr T unknown = (T)~T(0);
+        int best = 0;
+        for (int i = 0; i < m_stride; i += 2) {
+            if (v[i] != unknown && t[i] != unknown) best = std::max(best, (int)t[i] - (int)v[i]);
+            if (v[i + 1] != unknown && t[i + 1] != unknown) best = std::max(best, (int)v[i + 1] - (int)t[i + 1]);
+        }
+        return best;
+    }
+
+    void resetTables();
+    void addLandmark(Node landmark); // Appends it and fills its two columns of m_table
+    Node randomNode(uint64_t salt) const; // A node with incoming edges, -1 if none
+    Node farthestLandmark(uint64_t salt) const;
+    Node avoidLandmark(uint64_t salt) const;
+    void narrow(); // Moves m_table to m_narrow when every distance fits
+    template <typename T>
+    bool propagate(std::vector<T>& table, int unit, const std::vector<Node>& changed); // false if a value no longer fits
+    void applyPending() const;
+    void clearPending();
+
+    const IGraph& m_base;
+    const Grid* m_grid = nullptr; // The base when it is a Grid, until it is destroyed
+    std::vector<Node> m_landmarks;
+    int m_count = 0;
+    LandmarkSelection m_selection = LandmarkSelection::Avoid;
+    uint64_t m_seed = 1;
+    int m_stride = 0; // 2 * landmark count
+    int m_rows = -1;  // nodeCount the tables were built for
+    bool m_wide = true;
+    std::vector<uint32_t> m_table;  // Used when m_wide
+    std::vector<uint16_t> m_narrow; // Used otherwise, in multiples of m_unit
+    int m_unit = 1;
+    double m_buildMs = 0;
+
+    // Edits reported by the grid, not yet in the tables
+    std::vector<Node> m_pending;
+    std::vector<char> m_isPending; // Per node, dedupes m_pending
+    bool m_pendingReset = false;
+    mutable std::atomic<bool> m_pendingEdits{ false };
+    mutable std::mutex m_syncMutex;
+};
+
+// Non-virtual view of a LandmarkGraph over a Grid: grid expansion inlined as in
+// GridView, heuristic = max(octile/Manhattan, landmark bound)
+template <bool Diagonal>
+class LandmarkGridView {
+public:
+    LandmarkGridView(const LandmarkGraph& alt, const Grid& grid) : m_alt(alt), m_grid(grid) {}
+    int nodeCount() const { return m_grid.nodeCount(); }
+    int getHeuristic(Node from, Node target) const {
+        return std::max(m_grid.heuristic<Diagonal>(from, target), m_alt.lowerBound(from, target));
+    }
+    template <typename F>
+    void forEachNeighbor(Node n, F&& visit) const { m_grid.forEachNeighbor<Diagonal>(n, visit); }
+    template <typename F>
+    void forEachPredecessor(Node n, F&& visit) const { m_grid.forEachPredecessor<Diagonal>(n, visit); }
+    const Grid& grid() const { return m_grid; }
+
+private:
+    const LandmarkGraph& m_alt;
+    const Grid& m_grid;
+};
+
+// A* entry points over a LandmarkGraph (Algorithms.h has the IGraph ones): over a
+// Grid base they search through LandmarkGridView, otherwise through the virtual API
+AlgoResult runAStar(const LandmarkGraph& graph, Node start, Node end, IAlgorithmObserver* observer = nullptr, QueueKind queue = QueueKind::BinaryHeap);
+AlgoResult runBiAStar(const LandmarkGraph& graph, Node start, Node end, IAlgorithmObserver* observer = nullptr, QueueKind queue = QueueKind::BinaryHeap);
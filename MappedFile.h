@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Native file paths: wide on Windows so they can come straight from the common dialogs
+#ifdef _WIN32
+using FilePath = std::wstring;
+#else
+using FilePath = std::string;
+#endif
+
+// Read-only view of a whole file, unmapped on destruction. data() is null when the
+// file cannot be opened or mapped, or is empty. Not used by the Wasm build.
+class MappedFile {
+public:
+    // sequential hints the OS to read ahead, for files parsed front to back
+    explicit MappedFile(const FilePath& path, bool sequential = true);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr; // HANDLEs, kept opaque so <windows.h> stays out of the header
+    void* m_mapping = nullptr;
+#endif
+};
@@ -0,0 +1,208 @@
+#include "MazeGenerator.h"
+#include "Random.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Maps below this many cells are generated on the calling thread
+constexpr size_t PARALLEL_MIN_CELLS = size_t(1) << 18;
+
+int workerCount(const MazeOptions& options, size_t cells) {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    (void)options; (void)cells;
+    return 1; // No std::thread without -pthread
+#else
+    if (cells < PARALLEL_MIN_CELLS) return 1;
+    int n = options.threads > 0 ? options.threads : (int)std::thread::hardware_concurrency();
+    return std::max(1, n);
+#endif
+}
+
+// Runs body(begin, end) over [0, count) split into `threads` contiguous bands
+template <typename F>
+void parallelBands(size_t count, int threads, F&& body) {
+    threads = (int)std::min<size_t>(std::max(threads, 1), std::max<size_t>(count, 1));
+    if (threads == 1) {
+        body(size_t(0), count);
+        return;
+    }
+    std::vector<std::thread> workers;
+    size_t chunk = (count + threads - 1) / threads;
+    for (int t = 1; t < threads; ++t) {
+        size_t begin = std::min(count, t * chunk);
+        size_t end = std::min(count, begin + chunk);
+        workers.emplace_back([&body, begin, end]() { body(begin, end); });
+    }
+    body(size_t(0), std::min(count, chunk));
+    for (auto& w : workers) w.join();
+}
+
+// Uniform double in [0, 1) from a 64-bit draw
+double unit(uint64_t bits) { return (bits >> 11) * (1.0 / 9007199254740992.0); }
+
+} // namespace
+
+struct MazeGenerator {
+    // Rewrites every cell from cell(i) -> {wall, weight}. Bands are whole 64-cell
+    // bitset words, so no two threads ever touch the same word.
+    template <typename F>
+    static void fill(Grid& grid, int threads, F&& cell) {
+        size_t cells = (size_t)grid.width * grid.height;
+        size_t words = grid.obstacles.size();
+        std::atomic<int> weighted(0);
+        parallelBands(words, threads, [&](size_t begin, size_t end) {
+            int count = 0;
+            for (size_t w = begin; w < end; ++w) {
+                uint64_t bits = 0;
+                size_t last = std::min(cells, (w + 1) * 64);
+                for (size_t i = w * 64; i < last; ++i) {
+                    auto c = cell(i);
+                    if (c.first) bits |= uint64_t(1) << (i & 63);
+                    grid.weights[i] = c.second;
+                    count += c.second != 1;
+                }
+                grid.obstacles[w] = bits;
+            }
+            weighted += count;
+        });
+        grid.weightedCells = weighted;
+        grid.setObstacleBit(grid.index(grid.source.x, grid.source.y), false);
+        grid.setObstacleBit(grid.index(grid.destination.x, grid.destination.y), false);
+        grid.m_listeners.reset();
+    }
+
+    static void noise(Grid& grid, const MazeOptions& o, int threads) {
+        uint64_t density = o.density >= 0 ? o.density : 30;
+        fill(grid, threads, [&](size_t i) {
+            return std::make_pair(hashDraw(o.seed, 0, i) % 100 < density, uint16_t(1));
+        });
+    }
+
+    // Random fill, then a few rounds of the 4-5 rule: a cell becomes wall when at
+    // least 5 of its 3x3 block (itself included, off-map counts as wall) are walls.
+    static void caves(Grid& grid, const MazeOptions& o, int threads) {
+        int h = grid.height, w = grid.width;
+        uint64_t fillPercent = o.density >= 0 ? o.density : 45;
+        std::vector<uint8_t> cur((size_t)h * w), next((size_t)h * w);
+        parallelBands(cur.size(), threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) cur[i] = hashDraw(o.seed, 1, i) % 100 < fillPercent;
+        });
+        for (int round = 0; round < 4; ++round) {
+            parallelBands((size_t)h, threads, [&](size_t rowBegin, size_t rowEnd) {
+                for (int x = (int)rowBegin; x < (int)rowEnd; ++x) {
+                    for (int y = 0; y < w; ++y) {
+                        int walls = 0;
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            for (int dy = -1; dy <= 1; ++dy) {
+                                int nx = x + dx, ny = y + dy;
+                                walls += (nx < 0 || nx >= h || ny < 0 || ny >= w) ? 1 : cur[(size_t)nx * w + ny];
+                            }
+                        }
+                        next[(size_t)x * w + y] = walls >= 5;
+                    }
+                }
+            });
+            cur.swap(next);
+        }
+        fill(grid, threads, [&](size_t i) { return std::make_pair(cur[i] != 0, uint16_t(1)); });
+    }
+
+    // Perfect maze on the odd cells. Inherently sequential (one DFS).
+    static void backtracker(Grid& grid, const MazeOptions& o, int threads) {
+        int h = grid.height, w = grid.width;
+        std::vector<uint8_t> wall((size_t)h * w, 1);
+        if (h >= 3 && w >= 3) {
+            Rng rng(o.seed);
+            std::vector<Point> stack = { {1, 1} };
+            wall[(size_t)w + 1] = 0;
+            const int dx[] = {-2, 2, 0, 0};
+            const int dy[] = {0, 0, -2, 2};
+            while (!stack.empty()) {
+                Point p = stack.back();
+                int options[4], count = 0;
+                for (int d = 0; d < 4; ++d) {
+                    int nx = p.x + dx[d], ny = p.y + dy[d];
+                    if (nx > 0 && nx < h - 1 && ny > 0 && ny < w - 1 && wall[(size_t)nx * w + ny]) options[count++] = d;
+                }
+                if (count == 0) {
+                    stack.pop_back();
+                    continue;
+                }
+                int d = options[rng.below(count)];
+                int nx = p.x + dx[d], ny = p.y + dy[d];
+                wall[(size_t)(p.x + dx[d] / 2) * w + p.y + dy[d] / 2] = 0;
+                wall[(size_t)nx * w + ny] = 0;
+                stack.push_back({ nx, ny });
+            }
+            // Endpoints usually sit on wall cells; open a short link to the nearest room
+            auto link = [&](Point e) {
+                int maxRx = (h - 2) % 2 ? h - 2 : h - 3, maxRy = (w - 2) % 2 ? w - 2 : w - 3;
+                int rx = std::max(1, std::min(e.x % 2 ? e.x : e.x - 1, maxRx));
+                int ry = std::max(1, std::min(e.y % 2 ? e.y : e.y - 1, maxRy));
+                for (int x = std::min(e.x, rx); x <= std::max(e.x, rx); ++x) wall[(size_t)x * w + e.y] = 0;
+                for (int y = std::min(e.y, ry); y <= std::max(e.y, ry); ++y) wall[(size_t)rx * w + y] = 0;
+            };
+            link(grid.source);
+            link(grid.destination);
+        }
+        fill(grid, threads, [&](size_t i) { return std::make_pair(wall[i] != 0, uint16_t(1)); });
+    }
+
+    // Four octaves of value noise. Low ground is water (walls), higher ground costs more.
+    static void terrain(Grid& grid, const MazeOptions& o, int threads) {
+        int h = grid.height, w = grid.width;
+        const int octaves = 4, basePeriod = 64;
+        // Lattice values per octave, drawn once so each cell only interpolates
+        std::vector<double> lattice[octaves];
+        int latticeW[octaves];
+        for (int octave = 0, period = basePeriod; octave < octaves; ++octave, period /= 2) {
+            int lh = h / period + 2;
+            latticeW[octave] = w / period + 2;
+            lattice[octave].resize((size_t)lh * latticeW[octave]);
+            for (size_t i = 0; i < lattice[octave].size(); ++i) lattice[octave][i] = unit(hashDraw(o.seed, 2 + octave, i));
+        }
+        auto smooth = [](double t) { return t * t * (3 - 2 * t); };
+        double waterLevel = o.density >= 0 ? o.density / 100.0 : 0.35;
+        fill(grid, threads, [&](size_t i) {
+            int x = (int)(i / w), y = (int)(i % w);
+            double v = 0, amplitude = 1, total = 0;
+            for (int octave = 0, period = basePeriod; octave < octaves; ++octave, period /= 2) {
+                const double* row = &lattice[octave][(size_t)(x / period) * latticeW[octave] + y / period];
+                const double* below = row + latticeW[octave];
+                double fx = smooth((x % period) / (double)period), fy = smooth((y % period) / (double)period);
+                double top = row[0] + (row[1] - row[0]) * fy;
+                double bottom = below[0] + (below[1] - below[0]) * fy;
+                v += amplitude * (top + (bottom - top) * fx);
+                total += amplitude;
+                amplitude *= 0.5;
+            }
+            v /= total;
+            if (v < waterLevel) return std::make_pair(true, uint16_t(1));
+            double t = std::min(1.0, (v - waterLevel) / (1.0 - waterLevel) * 1.6);
+            return std::make_pair(false, uint16_t(1 + (int)(t * t * 9)));
+        });
+    }
+};
+
+void generateMaze(Grid& grid, const MazeOptions& options) {
+    int threads = workerCount(options, (size_t)grid.getWidth() * grid.getHeight());
+    switch (options.kind) {
+    case MazeKind::Noise: MazeGenerator::noise(grid, options, threads); break;
+    case MazeKind::Backtracker: MazeGenerator::backtracker(grid, options, threads); break;
+    case MazeKind::Caves: MazeGenerator::caves(grid, options, threads); break;
+    case MazeKind::Terrain: MazeGenerator::terrain(grid, options, threads); break;
+    }
+}
+
+const char* mazeKindName(MazeKind kind) {
+    switch (kind) {
+    case MazeKind::Noise: return "noise";
+    case MazeKind::Backtracker: return "backtracker";
+    case MazeKind::Caves: return "caves";
+    case MazeKind::Terrain: return "terrain";
+    }
+    return "?";
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Grid.h"
+#include <cstdint>
+
+// Seeded map generators. The same kind, seed and grid size always produce the same
+// map, whatever the thread count.
+enum class MazeKind {
+    Noise,       // Independent random walls (generateRandomMaze's 30% pattern)
+    Backtracker, // Recursive-backtracker perfect maze on odd cells
+    Caves,       // Cellular-automata caves
+    Terrain      // Fractal value-noise weights with impassable low ground
+};
+
+struct MazeOptions {
+    MazeKind kind = MazeKind::Noise;
+    uint64_t seed = 1;
+    int density = -1; // Wall percentage for Noise / initial fill for Caves, -1 = default
+    int threads = 0;  // Worker threads for the parallel generators, 0 = hardware concurrency
+};
+
+// Rewrites every cell's wall bit and weight (weights reset to 1 except for Terrain).
+// Source and destination are always left open. Noise, Caves and Terrain run in
+// parallel bands on large maps; Backtracker is sequential.
+void generateMaze(Grid& grid, const MazeOptions& options);
+
+const char* mazeKindName(MazeKind kind);
@@ -0,0 +1,230 @@
+#include "ParallelBFS.h"
+#include "SearchKernels.h"
+#include <algorithm>
+
+namespace {
+
+// Direction switch thresholds from Beamer et al., in nodes rather than edges
+// (degrees are near uniform on grids): go bottom-up when the frontier exceeds
+// 1/ALPHA of the unvisited nodes, back to top-down below 1/BETA of all nodes.
+constexpr size_t ALPHA = 14;
+constexpr size_t BETA = 24;
+
+constexpr size_t BOTTOM_UP_CHUNK_WORDS = 64;
+
+} // namespace
+
+ParallelBFSEngine::ParallelBFSEngine(int threads) : m_pool(threads) {
+    for (int i = 0; i < m_pool.threadCount(); ++i) m_workers.push_back(std::make_unique<Worker>());
+}
+
+// Every worker's frontier list as one sequence, handed out in chunks
+template <typename F>
+void ParallelBFSEngine::forEachFrontierNode(int slot, F&& visit) {
+    const int threads = threadCount();
+    size_t total = 0;
+    for (const auto& w : m_workers) total += w->frontierSize[slot];
+    const size_t chunk = std::max<size_t>(16, std::min<size_t>(1024, total / (threads * 8)));
+    std::atomic<size_t>& cursor = m_cursor[slot];
+    while (true) {
+        size_t begin = cursor.fetch_add(chunk, std::memory_order_relaxed);
+        if (begin >= total) return;
+        size_t end = std::min(total, begin + chunk);
+        size_t offset = 0;
+        for (int t = 0; t < threads && begin < end; ++t) {
+            size_t size = m_workers[t]->frontierSize[slot];
+            if (begin < offset + size) {
+                const int* list = m_workers[t]->lists[slot].data() - offset;
+                size_t stop = std::min(end, offset + size);
+                for (size_t i = begin; i < stop; ++i) visit(list[i]);
+                begin = stop;
+            }
+            offset += size;
+        }
+    }
+}
+
+// Run by every worker in lockstep, one level per iteration. Every decision is
+// taken from values published before a barrier, so all workers agree on it.
+template <typename Graph>
+void ParallelBFSEngine::search(int self, const Graph& graph) {
+    Worker& w = *m_workers[self];
+    const int threads = threadCount();
+    const size_t n = (size_t)m_graph->nodeCount();
+    const size_t words = (n + 63) / 64;
+    const size_t wordBegin = words * self / threads, wordEnd = words * (self + 1) / threads;
+    auto isSet = [](const std::atomic<uint64_t>* bits, size_t id) {
+        return (bits[id >> 6].load(std::memory_order_relaxed) >> (id & 63)) & 1;
+    };
+
+    for (size_t i = wordBegin; i < wordEnd; ++i) m_visited[i].store(0, std::memory_order_relaxed);
+    w.lists[0].clear();
+    int slot = 0;
+    if (self == 0) m_cursor[0].store(0, std::memory_order_relaxed);
+    m_pool.barrier();
+    if (self == 0) {
+        m_visited[m_start.id >> 6].fetch_or(uint64_t(1) << (m_start.id & 63), std::memory_order_relaxed);
+        m_level[m_start.id] = 0;
+        w.lists[0].push_back(m_start.id);
+    }
+    w.frontierSize[slot] = w.lists[0].size();
+    w.reachedEnd[slot] = self == 0 && m_start == m_end;
+    m_pool.barrier();
+
+    bool bottomUp = false;
+    int bits = 0; // m_frontierBits[bits] holds the frontier while bottom-up
+    long long expanded = 0;
+    size_t seen = 0;
+    for (int level = 0;; ++level) {
+        size_t frontierCount = 0;
+        bool reachedEnd = false;
+        for (const auto& other : m_workers) {
+            frontierCount += other->frontierSize[slot];
+            reachedEnd = reachedEnd || other->reachedEnd[slot];
+        }
+        seen += frontierCount;
+        if (frontierCount == 0) break;
+        if (reachedEnd) {
+            if (self == 0) m_found = true;
+            break;
+        }
+        // The other slot's cursor serves the next level; nobody touches it until the barrier below
+        if (self == 0) m_cursor[slot ^ 1].store(0, std::memory_order_relaxed);
+
+        // Level 0 always goes top-down: the start may have out-edges that are nobody's
+        // in-edges (a Grid start placed on a wall)
+        bool wantBottomUp = bottomUp ? frontierCount >= n / BETA : level > 0 && frontierCount > (n - seen) / ALPHA;
+        if (wantBottomUp && !bottomUp) {
+            for (size_t i = wordBegin; i < wordEnd; ++i) m_frontierBits[bits][i].store(0, std::memory_order_relaxed);
+            m_pool.barrier();
+            for (int v : w.lists[slot]) m_frontierBits[bits][v >> 6].fetch_or(uint64_t(1) << (v & 63), std::memory_order_relaxed);
+            m_pool.barrier();
+        } else if (!wantBottomUp && bottomUp) {
+            // Into the other slot, free since every worker read this one above
+            slot ^= 1;
+            std::vector<int>& list = w.lists[slot];
+            list.clear();
+            for (size_t i = wordBegin; i < wordEnd; ++i) {
+                for (uint64_t word = m_frontierBits[bits][i].load(std::memory_order_relaxed); word; word &= word - 1) {
+                    list.push_back((int)(i * 64 + __builtin_ctzll(word)));
+                }
+            }
+            w.frontierSize[slot] = list.size();
+            w.reachedEnd[slot] = false;
+            if (self == 0) m_cursor[slot ^ 1].store(0, std::memory_order_relaxed);
+            m_pool.barrier();
+        }
+        bottomUp = wantBottomUp;
+        expanded += frontierCount;
+        reachedEnd = false;
+
+        if (!bottomUp) {
+            std::vector<int>& next = w.lists[slot ^ 1];
+            next.clear();
+            forEachFrontierNode(slot, [&](int u) {
+                graph.forEachNeighbor(Node{ u }, [&](Node target, int) {
+                    uint64_t bit = uint64_t(1) << (target.id & 63);
+                    std::atomic<uint64_t>& word = m_visited[target.id >> 6];
+                    if (word.load(std::memory_order_relaxed) & bit) return;
+                    if (word.fetch_or(bit, std::memory_order_relaxed) & bit) return; // Another worker claimed it
+                    m_level[target.id] = level + 1;
+                    next.push_back(target.id);
+                    reachedEnd = reachedEnd || target == m_end;
+                });
+            });
+            slot ^= 1;
+            w.frontierSize[slot] = next.size();
+            w.reachedEnd[slot] = reachedEnd;
+        } else {
+            const std::atomic<uint64_t>* frontier = m_frontierBits[bits].get();
+            std::atomic<uint64_t>* next = m_frontierBits[bits ^ 1].get();
+            size_t claimed = 0;
+            std::atomic<size_t>& cursor = m_cursor[slot];
+            while (true) {
+                size_t begin = cursor.fetch_add(BOTTOM_UP_CHUNK_WORDS, std::memory_order_relaxed);
+                if (begin >= words) break;
+                size_t end = std::min(words, begin + BOTTOM_UP_CHUNK_WORDS);
+                for (size_t i = begin; i < end; ++i) {
+                    uint64_t visited = m_visited[i].load(std::memory_order_relaxed);
+                    uint64_t open = ~visited;
+                    if (i == words - 1 && n % 64) open &= (uint64_t(1) << (n % 64)) - 1;
+                    uint64_t found = 0;
+                    for (; open; open &= open - 1) {
+                        int v = (int)(i * 64 + __builtin_ctzll(open));
+                        bool hit = false;
+                        graph.forEachPredecessor(Node{ v }, [&](Node source, int) {
+                            hit = hit || isSet(frontier, source.id);
+                        });
+                        if (hit) {
+                            found |= open & -open;
+                            m_level[v] = level + 1;
+                            reachedEnd = reachedEnd || v == m_end.id;
+                        }
+                    }
+                    // This worker owns word i for the step, so plain stores suffice
+                    next[i].store(found, std::memory_order_relaxed);
+                    if (found) m_visited[i].store(visited | found, std::memory_order_relaxed);
+                    claimed += __builtin_popcountll(found);
+                }
+            }
+            bits ^= 1;
+            slot ^= 1;
+            w.frontierSize[slot] = claimed;
+            w.reachedEnd[slot] = reachedEnd;
+        }
+        m_pool.barrier();
+    }
+    if (self == 0) m_expanded = expanded;
+}
+
+AlgoResult ParallelBFSEngine::run(const IGraph& graph, Node start, Node end) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    AlgoResult res = { {}, 0, 0, 0, false };
+    const int n = graph.nodeCount();
+    if (start.id < 0 || start.id >= n || end.id < 0 || end.id >= n) {
+        res.timeMs = elapsedMs(startTime);
+        return res;
+    }
+
+    size_t words = ((size_t)n + 63) / 64;
+    if (m_words < words) {
+        m_visited.reset(new std::atomic<uint64_t>[words]);
+        for (auto& b : m_frontierBits) b.reset(new std::atomic<uint64_t>[words]);
+        m_words = words;
+    }
+    m_level.resize(n);
+
+    m_graph = &graph;
+    m_start = start;
+    m_end = end;
+    m_found = false;
+    m_pool.run([&](int self) {
+        dispatchGraph(graph, nullptr, [&](const auto& view, const auto&) { search(self, view); });
+    });
+
+    res.visitedCount = (int)m_expanded;
+    if (m_found) {
+        res.success = true;
+        res.visitedCount++; // The target itself
+        res.totalCost = m_level[end.id];
+        // Walk back one level at a time; level 1 leads straight to the start
+        std::vector<Edge> predecessors;
+        res.path.resize(res.totalCost + 1);
+        res.path[0] = start;
+        Node curr = end;
+        for (int level = res.totalCost; level > 0; --level) {
+            res.path[level] = curr;
+            if (level == 1) break;
+            graph.getPredecessors(curr, predecessors);
+            for (const Edge& e : predecessors) {
+                int id = e.target.id;
+                if (((m_visited[id >> 6].load(std::memory_order_relaxed) >> (id & 63)) & 1) && m_level[id] == level - 1) {
+                    curr = e.target;
+                    break;
+                }
+            }
+        }
+    }
+    res.timeMs = elapsedMs(startTime);
+    return res;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "Algorithms.h"
+#include "WorkerPool.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Level-synchronous BFS over a thread pool for large unweighted searches.
+// Each level is expanded either top-down (the frontier's out-edges, split in
+// chunks over the workers, new nodes claimed with an atomic bit in the visited
+// bitmap) or bottom-up (every unvisited node scans its predecessors for one in
+// the frontier bitmap; each worker owns whole 64-node words, so no atomics, and
+// on a Grid the scan walks memory row by row). The direction switches to
+// bottom-up once the frontier outgrows a fraction of the unvisited nodes and
+// back when it shrinks again (Beamer et al.'s direction-optimizing BFS).
+//
+// Same AlgoResult as runBFS: a fewest-hops path, totalCost = hop count, and
+// visitedCount = nodes expanded, which is identical when the target is
+// unreachable. When it is reachable the target's own level is only counted up
+// to the target itself, not the nodes runBFS happens to dequeue before it, so
+// visitedCount can come out lower. The path is deterministic: each step back
+// from the target takes the first predecessor, in getPredecessors order, one
+// level closer to the start.
+//
+// Needs getPredecessors to be exact (see IGraph). The graph is read concurrently
+// through its const interface (see WorkerPool for Wasm).
+class ParallelBFSEngine {
+public:
+    explicit ParallelBFSEngine(int threads = 0); // 0 = hardware concurrency
+
+    // Worker count, the calling thread included
+    int threadCount() const { return m_pool.threadCount(); }
+
+    // One run at a time per engine
+    AlgoResult run(const IGraph& graph, Node start, Node end);
+
+private:
+    struct Worker {
+        // Top-down: this worker's share of a level, by level parity. Others read
+        // lists[slot] while this worker fills lists[slot ^ 1] with what it claims.
+        std::vector<int> lists[2];
+        size_t frontierSize[2] = { 0, 0 }; // Published per level, alternating like DeltaSteppingEngine's
+        bool reachedEnd[2] = { false, false }; // Claimed the target for that level, published alongside
+    };
+
+    template <typename Graph>
+    void search(int self, const Graph& graph);
+    template <typename F>
+    void forEachFrontierNode(int slot, F&& visit);
+
+    WorkerPool m_pool;
+    std::vector<std::unique_ptr<Worker>> m_workers; // Indexed like the pool's workers
+
+    // Current job
+    const IGraph* m_graph = nullptr;
+    Node m_start = { 0 }, m_end = { 0 };
+    long long m_expanded = 0;
+    bool m_found = false;
+
+    // Bitmaps, one bit per node: visited, and the frontier in two buffers
+    // (current / next) while the search runs bottom-up
+    std::unique_ptr<std::atomic<uint64_t>[]> m_visited;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_frontierBits[2];
+    size_t m_words = 0; // Bitmap capacity
+    std::vector<int> m_level; // Valid where the visited bit is set; written only by the claiming worker
+    std::atomic<size_t> m_cursor[2] = {}; // Next unclaimed chunk, by level parity (the idle one is reset for the next level)
+};
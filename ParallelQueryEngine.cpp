@@ -0,0 +1,96 @@
+#include "ParallelQueryEngine.h"
+#include "SearchKernels.h"
+#include <algorithm>
+
+ParallelQueryEngine::ParallelQueryEngine(int threads) : m_pool(threads) {
+    for (int i = 0; i < m_pool.threadCount(); ++i) m_workers.push_back(std::make_unique<Worker>());
+}
+
+// Own deque from the front (keeps neighbouring queries together), others' from the back
+bool ParallelQueryEngine::takeChunk(int self, Chunk& chunk) {
+    {
+        Worker& own = *m_workers[self];
+        std::lock_guard<std::mutex> lock(own.lock);
+        if (!own.chunks.empty()) {
+            chunk = own.chunks.front();
+            own.chunks.pop_front();
+            return true;
+        }
+    }
+    int n = (int)m_workers.size();
+    for (int i = 1; i < n; ++i) {
+        Worker& victim = *m_workers[(self + i) % n];
+        std::lock_guard<std::mutex> lock(victim.lock);
+        if (!victim.chunks.empty()) {
+            chunk = victim.chunks.back();
+            victim.chunks.pop_back();
+            return true;
+        }
+    }
+    return false; // Chunks are never added mid-job, so empty everywhere means done
+}
+
+void ParallelQueryEngine::work(int self) {
+    Worker& w = *m_workers[self];
+    w.paths.clear();
+    Chunk chunk;
+    while (takeChunk(self, chunk)) {
+        w.queries.assign(m_queries->begin() + chunk.begin, m_queries->begin() + chunk.end);
+        runBatch(*m_graph, w.queries, w.workspace, w.local, m_algorithm, m_queue);
+        for (int i = 0; i < (int)w.queries.size(); ++i) {
+            int q = chunk.begin + i;
+            m_cost[q] = w.local.cost(i);
+            m_visited[q] = w.local.visited(i);
+            m_pathRefs[q] = { self, (int)w.paths.size(), w.local.pathLength(i) };
+            w.paths.insert(w.paths.end(), w.local.path(i), w.local.path(i) + w.local.pathLength(i));
+        }
+    }
+}
+
+void ParallelQueryEngine::run(const IGraph& graph, const std::vector<PathQuery>& queries, BatchResult& result,
+                              BatchAlgorithm algorithm, QueueKind queue) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    const int n = (int)queries.size();
+    const int threads = threadCount();
+    m_cost.assign(n, 0);
+    m_visited.assign(n, 0);
+    m_pathRefs.assign(n, { 0, 0, 0 });
+
+    // Small chunks balance better; ~16 per thread leaves room to steal
+    int chunkSize = std::max(1, std::min(32, n / (threads * 16)));
+    int chunkCount = (n + chunkSize - 1) / chunkSize;
+    for (int t = 0; t < threads; ++t) {
+        Worker& w = *m_workers[t];
+        std::lock_guard<std::mutex> lock(w.lock);
+        w.chunks.clear();
+        // Contiguous runs of chunks per thread
+        int first = (int)((long long)chunkCount * t / threads), last = (int)((long long)chunkCount * (t + 1) / threads);
+        for (int c = first; c < last; ++c) w.chunks.push_back({ c * chunkSize, std::min(n, (c + 1) * chunkSize) });
+    }
+
+    m_graph = &graph;
+    m_queries = &queries;
+    m_algorithm = algorithm;
+    m_queue = queue;
+    m_pool.run([this](int self) { work(self); });
+
+    // Assemble in query order (layout in BatchSearch.h)
+    result.queryCount = n;
+    result.buffer.resize(3 * n + 1);
+    std::copy(m_cost.begin(), m_cost.end(), result.buffer.begin());
+    std::copy(m_visited.begin(), m_visited.end(), result.buffer.begin() + n);
+    int offset = 0;
+    result.buffer[2 * n] = 0;
+    for (int q = 0; q < n; ++q) {
+        offset += m_pathRefs[q].length;
+        result.buffer[2 * n + q + 1] = offset;
+    }
+    result.buffer.resize(3 * n + 1 + offset);
+    int* out = result.buffer.data() + 3 * n + 1;
+    for (int q = 0; q < n; ++q) {
+        const PathRef& ref = m_pathRefs[q];
+        const int* src = m_workers[ref.worker]->paths.data() + ref.offset;
+        out = std::copy(src, src + ref.length, out);
+    }
+    result.timeMs = elapsedMs(startTime);
+}
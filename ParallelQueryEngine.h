@@ -0,0 +1,65 @@
+#pragma once
+#include "BatchSearch.h"
+#include "WorkerPool.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Spreads batches of point-to-point queries over a fixed pool of threads.
+// Each thread owns a BatchWorkspace; queries are cut into small chunks dealt out
+// to per-thread deques, and a thread that runs dry steals from the back of the
+// others' deques, so a few expensive queries (long maze corridors, unreachable
+// targets) don't leave the other cores idle.
+//
+// The graph is only read, concurrently, through its const interface; a custom
+// IGraph must tolerate that. Results are assembled in query order, so the
+// output is identical to runBatch whatever the thread count or scheduling.
+// See WorkerPool for Wasm builds.
+class ParallelQueryEngine {
+public:
+    explicit ParallelQueryEngine(int threads = 0); // 0 = hardware concurrency
+
+    // Worker count, the calling thread included
+    int threadCount() const { return m_pool.threadCount(); }
+
+    // Same contract and buffer layout as runBatch. One run at a time per engine.
+    void run(const IGraph& graph, const std::vector<PathQuery>& queries, BatchResult& result,
+             BatchAlgorithm algorithm = BatchAlgorithm::Dijkstra, QueueKind queue = QueueKind::BinaryHeap);
+
+private:
+    struct Chunk {
+        int begin, end; // Query index range
+    };
+
+    struct Worker {
+        BatchWorkspace workspace;
+        std::vector<PathQuery> queries; // Current chunk
+        BatchResult local;              // Current chunk's results
+        std::vector<int> paths;         // Path nodes of every query this worker answered
+        std::mutex lock;                // Guards chunks
+        std::deque<Chunk> chunks;
+    };
+
+    // Where a query's path ended up: which worker's paths, and where
+    struct PathRef {
+        int worker, offset, length;
+    };
+
+    void work(int self);
+    bool takeChunk(int self, Chunk& chunk);
+
+    WorkerPool m_pool;
+    std::vector<std::unique_ptr<Worker>> m_workers; // Indexed like the pool's workers
+
+    // Current job
+    const IGraph* m_graph = nullptr;
+    const std::vector<PathQuery>* m_queries = nullptr;
+    BatchAlgorithm m_algorithm = BatchAlgorithm::Dijkstra;
+    QueueKind m_queue = QueueKind::BinaryHeap;
+
+    // Per-query results, written by whichever worker answered the query
+    std::vector<int> m_cost;
+    std::vector<int> m_visited;
+    std::vector<PathRef> m_pathRefs;
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include "IGraph.h"
+#include <vector>
+
+// Per-query visualization layer (visited / current / path), kept apart from the
+// terrain so a Grid stays immutable while it is being searched and can be shared
+// by several queries. Only touched cells are recorded, so clear() is O(touched).
+class PathOverlay {
+public:
+    static constexpr char NONE = '.';
+    static constexpr char VISITED = 'v';
+    static constexpr char CURRENT = 'c';
+    static constexpr char PATH = '*';
+
+    // Resizes for a graph with nodeCount nodes; a same-size reset only clears
+    void reset(int nodeCount) {
+        if ((int)marks.size() != nodeCount) {
+            marks.assign(nodeCount, NONE);
+            touched.clear();
+            currentId = -1;
+        } else {
+            clear();
+        }
+    }
+
+    void clear() {
+        for (int id : touched) marks[id] = NONE;
+        touched.clear();
+        currentId = -1;
+    }
+
+    void setVisited(Node n) { set(n.id, VISITED); }
+
+    // Only one node is "current" at a time; the previous one falls back to visited
+    void setCurrent(Node n) {
+        if (currentId != -1 && marks[currentId] == CURRENT) marks[currentId] = VISITED;
+        if (set(n.id, CURRENT)) currentId = n.id;
+    }
+
+    void markPath(const std::vector<Node>& path) {
+        for (const auto& n : path) set(n.id, PATH);
+    }
+
+    char get(Node n) const {
+        return (n.id >= 0 && n.id < (int)marks.size()) ? marks[n.id] : NONE;
+    }
+
+    const std::vector<int>& touchedNodes() const { return touched; }
+
+private:
+    bool set(int id, char mark) {
+        if (id < 0 || id >= (int)marks.size()) return false;
+        if (marks[id] == NONE) touched.push_back(id);
+        marks[id] = mark;
+        return true;
+    }
+
+    std::vector<char> marks;
+    std::vector<int> touched;
+    int currentId = -1;
+};
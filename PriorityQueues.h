@@ -0,0 +1,246 @@
+#pragma once
+#include "IGraph.h"
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <functional>
+#include <cstdint>
+
+// Interchangeable min-priority queues for the weighted search kernels.
+// Common interface:
+//   void reset(int nodeCount);
+//   bool empty() const;
+//   void push(Node n, int key);       // insert, or decrease-key when supported
+//   std::pair<int, Node> pop();       // remove and return a minimum-key entry
+//   int topKey();                     // minimum key without removing it (queue not empty)
+// Queues without decrease-key may hand back stale duplicates; the kernels skip
+// an entry whose key no longer matches the node's best distance.
+// RadixHeapQueue is monotone: pushed keys must not be smaller than the last popped
+// key (true for Dijkstra and for A* with a consistent heuristic). BucketQueue is
+// fastest under the same condition but stays correct without it.
+
+// Lazy-deletion binary heap (the original std::priority_queue behavior, same pop
+// order). Kept as a bare vector so reset() keeps its capacity for the next query.
+class BinaryHeapQueue {
+public:
+    void reset(int) { m_heap.clear(); }
+    bool empty() const { return m_heap.empty(); }
+    void push(Node n, int key) {
+        m_heap.push_back({ key, n });
+        std::push_heap(m_heap.begin(), m_heap.end(), std::greater<std::pair<int, Node>>());
+    }
+    int topKey() { return m_heap.front().first; }
+    std::pair<int, Node> pop() {
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<std::pair<int, Node>>());
+        auto top = m_heap.back();
+        m_heap.pop_back();
+        return top;
+    }
+
+private:
+    std::vector<std::pair<int, Node>> m_heap;
+};
+
+// Indexed D-ary heap with decrease-key: at most one entry per node
+template <int D = 4>
+class DaryHeapQueue {
+public:
+    // O(entries left over) when the node count is unchanged: popped nodes already read -1
+    void reset(int nodeCount) {
+        if ((int)m_pos.size() != nodeCount) m_pos.assign(nodeCount, -1);
+        else for (const auto& e : m_heap) m_pos[e.second.id] = -1;
+        m_heap.clear();
+    }
+    bool empty() const { return m_heap.empty(); }
+
+    void push(Node n, int key) {
+        int i = m_pos[n.id];
+        if (i == -1) {
+            i = (int)m_heap.size();
+            m_heap.push_back({ key, n });
+            m_pos[n.id] = i;
+        } else if (key < m_heap[i].first) {
+            m_heap[i].first = key;
+        } else {
+            return;
+        }
+        siftUp(i);
+    }
+
+    int topKey() { return m_heap[0].first; }
+
+    std::pair<int, Node> pop() {
+        auto top = m_heap[0];
+        m_pos[top.second.id] = -1;
+        auto last = m_heap.back();
+        m_heap.pop_back();
+        if (!m_heap.empty()) {
+            m_heap[0] = last;
+            m_pos[last.second.id] = 0;
+            siftDown(0);
+        }
+        return top;
+    }
+
+private:
+    void place(int i, const std::pair<int, Node>& e) {
+        m_heap[i] = e;
+        m_pos[e.second.id] = i;
+    }
+    void siftUp(int i) {
+        auto e = m_heap[i];
+        while (i > 0) {
+            int p = (i - 1) / D;
+            if (m_heap[p].first <= e.first) break;
+            place(i, m_heap[p]);
+            i = p;
+        }
+        place(i, e);
+    }
+    void siftDown(int i) {
+        auto e = m_heap[i];
+        int n = (int)m_heap.size();
+        while (true) {
+            int first = i * D + 1;
+            if (first >= n) break;
+            int best = first;
+            int last = first + D < n ? first + D : n;
+            for (int c = first + 1; c < last; ++c) {
+                if (m_heap[c].first < m_heap[best].first) best = c;
+            }
+            if (m_heap[best].first >= e.first) break;
+            place(i, m_heap[best]);
+            i = best;
+        }
+        place(i, e);
+    }
+
+    std::vector<std::pair<int, Node>> m_heap;
+    std::vector<int> m_pos; // Heap slot per node id, -1 if absent
+};
+
+// Monotone radix heap: bucket b holds keys whose highest bit differing from the
+// last popped key is b-1, so each entry is redistributed at most 32 times.
+class RadixHeapQueue {
+public:
+    void reset(int) {
+        for (auto& b : m_buckets) b.clear();
+        m_last = 0;
+        m_size = 0;
+    }
+    bool empty() const { return m_size == 0; }
+
+    void push(Node n, int key) {
+        uint32_t k = key < (int)m_last ? m_last : (uint32_t)key; // Clamp a non-monotone key
+        m_buckets[bucketOf(k)].push_back({ k, n });
+        ++m_size;
+    }
+
+    int topKey() {
+        refill();
+        return (int)m_last;
+    }
+
+    std::pair<int, Node> pop() {
+        refill();
+        auto e = m_buckets[0].back();
+        m_buckets[0].pop_back();
+        --m_size;
+        return { (int)e.first, e.second };
+    }
+
+private:
+    // Moves the smallest non-empty bucket down so bucket 0 holds the minimum keys
+    void refill() {
+        if (!m_buckets[0].empty()) return;
+        int b = 1;
+        while (m_buckets[b].empty()) ++b;
+        uint32_t minKey = m_buckets[b][0].first;
+        for (const auto& e : m_buckets[b]) minKey = e.first < minKey ? e.first : minKey;
+        m_last = minKey;
+        for (const auto& e : m_buckets[b]) m_buckets[bucketOf(e.first)].push_back(e);
+        m_buckets[b].clear();
+    }
+
+    int bucketOf(uint32_t key) const {
+        uint32_t diff = key ^ m_last;
+        return diff == 0 ? 0 : 32 - __builtin_clz(diff);
+    }
+
+    std::vector<std::pair<uint32_t, Node>> m_buckets[33];
+    uint32_t m_last = 0;
+    size_t m_size = 0;
+};
+
+// Dial's bucket queue: one bucket per integer key in a circular window that
+// spans the range of queued keys. Grid edge costs are small integers
+// (10*w / 14*w), so the window stays short and push/pop are O(1).
+class BucketQueue {
+public:
+    void reset(int) {
+        for (auto& b : m_ring) b.clear();
+        m_base = 0;
+        m_cursor = 0;
+        m_size = 0;
+    }
+    bool empty() const { return m_size == 0; }
+
+    void push(Node n, int key) {
+        if (m_size == 0) {
+            m_base = key;
+            m_top = key;
+            m_cursor = 0;
+        }
+        if (key < m_base) {
+            // Extend the window downwards, e.g. a key below the first one pushed
+            if (m_top - key >= (int)m_ring.size()) grow(m_top - key + 1);
+            m_cursor = (m_cursor + m_ring.size() - (m_base - key)) % m_ring.size();
+            m_base = key;
+        }
+        if (key > m_top) m_top = key;
+        int span = key - m_base;
+        if (span >= (int)m_ring.size()) grow(span + 1);
+        m_ring[(m_cursor + span) % m_ring.size()].push_back(n);
+        ++m_size;
+    }
+
+    int topKey() {
+        advance();
+        return m_base;
+    }
+
+    std::pair<int, Node> pop() {
+        advance();
+        Node n = m_ring[m_cursor].back();
+        m_ring[m_cursor].pop_back();
+        --m_size;
+        return { m_base, n };
+    }
+
+private:
+    // Moves the cursor to the first non-empty bucket
+    void advance() {
+        while (m_ring[m_cursor].empty()) {
+            m_cursor = (m_cursor + 1) % m_ring.size();
+            ++m_base;
+        }
+    }
+
+    // Re-lays the window out from the cursor into a ring of at least minSize buckets
+    void grow(size_t minSize) {
+        size_t newSize = m_ring.empty() ? 64 : m_ring.size();
+        while (newSize < minSize) newSize *= 2;
+        std::vector<std::vector<Node>> ring(newSize);
+        for (size_t i = 0; i < m_ring.size(); ++i) {
+            ring[i].swap(m_ring[(m_cursor + i) % m_ring.size()]);
+        }
+        m_ring.swap(ring);
+        m_cursor = 0;
+    }
+
+    std::vector<std::vector<Node>> m_ring;
+    int m_base = 0;   // Key of the bucket at m_cursor
+    int m_top = 0;    // Largest key currently in the window
+    size_t m_cursor = 0;
+    size_t m_size = 0;
+};
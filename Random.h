@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+
+// Small, fast PRNG utilities with identical output on every platform
+// (unlike rand(), whose sequence and range depend on the C library).
+
+// Stateless 64-bit mixer (SplitMix64 finalizer)
+inline uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Counter-based draw: the same (seed, stream, index) always gives the same value,
+// so cells can be generated in any order or on any thread.
+inline uint64_t hashDraw(uint64_t seed, uint64_t stream, uint64_t index) {
+    return mix64(seed ^ mix64(stream * 0x9E3779B97F4A7C15ull + index));
+}
+
+// Sequential SplitMix64 generator
+struct Rng {
+    uint64_t state;
+    explicit Rng(uint64_t seed) : state(seed) {}
+    uint64_t next() { return mix64(state += 0x9E3779B97F4A7C15ull); }
+    int below(int n) { return (int)(next() % (uint64_t)n); } // n > 0
+};
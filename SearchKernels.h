@@ -0,0 +1,422 @@
+#pragma once
+#include "Algorithms.h"
+#include "SearchWorkspace.h"
+#include "PriorityQueues.h"
+#include "Grid.h"
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+// Search kernels templated over the graph type. A graph model provides:
+//   int  nodeCount() const;
+//   int  getHeuristic(Node from, Node target) const;
+//   template <typename F> void forEachNeighbor(Node n, F&& visit) const; // visit(Node target, int weight)
+//   template <typename F> void forEachPredecessor(Node n, F&& visit) const; // bidirectional kernels only
+// Instantiated with GridView<Diagonal> everything inlines; VirtualGraphView
+// adapts any IGraph through its virtual buffer API. The weighted kernels are
+// also templated on a queue from PriorityQueues.h.
+
+// Adapter exposing an arbitrary IGraph through the kernel graph model
+class VirtualGraphView {
+public:
+    explicit VirtualGraphView(const IGraph& graph) : m_graph(graph) { m_buffer.reserve(8); }
+    int nodeCount() const { return m_graph.nodeCount(); }
+    int getHeuristic(Node from, Node target) const { return m_graph.getHeuristic(from, target); }
+
+    template <typename F>
+    void forEachNeighbor(Node n, F&& visit) const {
+        m_graph.getNeighbors(n, m_buffer); // Buffer is reused, visit must not re-enter
+        for (const auto& edge : m_buffer) visit(edge.target, edge.weight);
+    }
+
+    template <typename F>
+    void forEachPredecessor(Node n, F&& visit) const {
+        m_graph.getPredecessors(n, m_buffer);
+        for (const auto& edge : m_buffer) visit(edge.target, edge.weight);
+    }
+
+private:
+    const IGraph& m_graph;
+    mutable std::vector<Edge> m_buffer;
+};
+
+// Observer policies. Kernels report through one of these instead of a raw
+// IAlgorithmObserver*: NoObserver compiles every hook away for headless runs,
+// ObserverSink forwards only the events its observer asked for.
+struct NoObserver {
+    void visited(Node) const {}
+    void log(const char*) const {}
+    template <typename MakeMessage>
+    void logWith(MakeMessage&&) const {}
+};
+
+class ObserverSink {
+public:
+    explicit ObserverSink(IAlgorithmObserver* observer)
+        : m_observer(observer), m_caps(observer ? observer->capabilities() : 0) {}
+
+    void visited(Node n) const { if (m_caps & IAlgorithmObserver::VISITED) m_observer->onNodeVisited(n); }
+    void log(const char* msg) const { if (m_caps & IAlgorithmObserver::LOG) m_observer->onLog(msg); }
+    // The message is only built when the observer actually consumes logs
+    template <typename MakeMessage>
+    void logWith(MakeMessage&& makeMessage) const { if (m_caps & IAlgorithmObserver::LOG) m_observer->onLog(makeMessage()); }
+
+private:
+    IAlgorithmObserver* m_observer;
+    unsigned m_caps;
+};
+
+// Runtime -> compile-time dispatch helpers shared by the entry points.
+// dispatchQueue hands the kernel a QueueTag<Q> naming the queue type for a QueueKind;
+// dispatchObserver hands it NoObserver when nothing would be consumed;
+// dispatchGraph picks the graph view and then the observer.
+template <typename Q> struct QueueTag { using type = Q; };
+
+template <typename Kernel>
+auto dispatchQueue(QueueKind kind, Kernel&& kernel) {
+    switch (kind) {
+        case QueueKind::DaryHeap: return kernel(QueueTag<DaryHeapQueue<4>>());
+        case QueueKind::RadixHeap: return kernel(QueueTag<RadixHeapQueue>());
+        case QueueKind::Bucket: return kernel(QueueTag<BucketQueue>());
+        default: return kernel(QueueTag<BinaryHeapQueue>());
+    }
+}
+
+template <typename Kernel>
+auto dispatchObserver(IAlgorithmObserver* observer, Kernel&& kernel) {
+    if (!observer || observer->capabilities() == 0) return kernel(NoObserver());
+    return kernel(ObserverSink(observer));
+}
+
+// Runs kernel on one graph model with the observer dispatched. Modules with
+// their own graph types use it to run the kernels on their own views.
+template <typename View, typename Kernel>
+auto dispatchView(const View& view, IAlgorithmObserver* observer, Kernel&& kernel) {
+    return dispatchObserver(observer, [&](const auto& sink) { return kernel(view, sink); });
+}
+
+// Picks the most specialized kernel instantiation for the runtime graph and
+// observer: Grid gets an inlined 4- or 8-connected view, anything else goes
+// through the virtual adapter; a missing or capability-less observer compiles
+// out entirely. Graph types defined elsewhere (CsrGraph, LandmarkGraph) overload
+// the entry points and call dispatchView themselves.
+template <typename Kernel>
+auto dispatchGraph(const IGraph& graph, IAlgorithmObserver* observer, Kernel&& kernel) {
+    if (const Grid* grid = dynamic_cast<const Grid*>(&graph)) {
+        if (grid->getAllowDiagonals()) return dispatchView(GridView<true>(*grid), observer, kernel);
+        return dispatchView(GridView<false>(*grid), observer, kernel);
+    }
+    return dispatchView(VirtualGraphView(graph), observer, kernel);
+}
+
+// Reconstructs start -> end from the workspace parent array, empty if unreached
+inline std::vector<Node> reconstructPath(const SearchWorkspace& ws, Node start, Node end) {
+    std::vector<Node> path;
+    if (!ws.reached(end)) return path;
+    Node curr = end;
+    while (curr.id != -1) {
+        path.push_back(curr);
+        if (curr == start) break;
+        curr = { ws.parent(curr.id) };
+    }
+    std::reverse(path.begin(), path.end());
+    if (path.empty() || path[0] != start) return {};
+    return path;
+}
+
+inline double elapsedMs(std::chrono::high_resolution_clock::time_point startTime) {
+    auto endTime = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+// Each kernel comes in two forms: one owning its workspace and queue, and one
+// running on caller-owned state (reset on entry) so that a batch of queries
+// reuses the same allocations.
+template <typename Queue, typename Graph, typename Observer>
+AlgoResult dijkstraSearch(const Graph& graph, Node start, Node end, const Observer& observer) {
+    SearchWorkspace ws;
+    Queue pq;
+    return dijkstraSearch(graph, start, end, observer, ws, pq);
+}
+
+template <typename Graph, typename Observer, typename Queue>
+AlgoResult dijkstraSearch(const Graph& graph, Node start, Node end, const Observer& observer, SearchWorkspace& ws, Queue& pq) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    AlgoResult res = { {}, 0, 0, 0, false };
+
+    ws.reset(graph.nodeCount());
+    pq.reset(graph.nodeCount());
+
+    ws.set(start.id, 0, -1);
+    pq.push(start, 0);
+
+    observer.log("Core: Starting Dijkstra...");
+
+    while (!pq.empty()) {
+        auto [d, curr] = pq.pop();
+
+        if (d > ws.dist(curr.id)) continue; // Stale duplicate
+
+        res.visitedCount++;
+        observer.visited(curr);
+
+        if (curr == end) {
+            res.success = true;
+            break;
+        }
+
+        graph.forEachNeighbor(curr, [&](Node target, int weight) {
+            int newDist = d + weight;
+            if (newDist < ws.dist(target.id)) {
+                ws.set(target.id, newDist, curr.id);
+                pq.push(target, newDist);
+                observer.logWith([&] { return "Core: Node " + std::to_string(target.id) + " reachable with distance " + std::to_string(newDist); });
+            }
+        });
+    }
+
+    res.path = reconstructPath(ws, start, end);
+    if (res.success) res.totalCost = ws.dist(end.id);
+
+    res.timeMs = elapsedMs(startTime);
+    return res;
+}
+
+template <typename Graph, typename Observer>
+AlgoResult bfsSearch(const Graph& graph, Node start, Node end, const Observer& observer) {
+    SearchWorkspace ws;
+    std::vector<Node> fifo;
+    return bfsSearch(graph, start, end, observer, ws, fifo);
+}
+
+// fifo is the BFS queue: every node enters at most once, so a vector read from the front suffices
+template <typename Graph, typename Observer>
+AlgoResult bfsSearch(const Graph& graph, Node start, Node end, const Observer& observer, SearchWorkspace& ws, std::vector<Node>& fifo) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    AlgoResult res = { {}, 0, 0, 0, false };
+
+    ws.reset(graph.nodeCount()); // dist holds the hop count
+    fifo.clear();
+    size_t head = 0;
+
+    ws.set(start.id, 0, -1);
+    fifo.push_back(start);
+
+    observer.log("Core: Starting Breadth-First Search (BFS)...");
+
+    while (head < fifo.size()) {
+        Node curr = fifo[head++];
+
+        res.visitedCount++;
+        observer.visited(curr);
+
+        if (curr == end) {
+            res.success = true;
+            observer.log("Core: Target node reached by BFS.");
+            break;
+        }
+
+        graph.forEachNeighbor(curr, [&](Node target, int) {
+            if (!ws.reached(target)) {
+                ws.set(target.id, ws.dist(curr.id) + 1, curr.id);
+                fifo.push_back(target);
+                observer.logWith([&] { return "Core: Enqueuing neighbor node " + std::to_string(target.id); });
+            }
+        });
+    }
+
+    res.path = reconstructPath(ws, start, end);
+    if (res.success) {
+        res.totalCost = (int)res.path.size() - 1;
+        observer.log("Core: BFS finished. Path found.");
+    } else {
+        observer.log("Core: BFS finished. No path found.");
+    }
+
+    res.timeMs = elapsedMs(startTime);
+    return res;
+}
+
+template <typename Queue, typename Graph, typename Observer>
+AlgoResult aStarSearch(const Graph& graph, Node start, Node end, const Observer& observer) {
+    SearchWorkspace ws;
+    Queue pq;
+    return aStarSearch(graph, start, end, observer, ws, pq);
+}
+
+template <typename Graph, typename Observer, typename Queue>
+AlgoResult aStarSearch(const Graph& graph, Node start, Node end, const Observer& observer, SearchWorkspace& ws, Queue& pq) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    AlgoResult res = { {}, 0, 0, 0, false };
+
+    ws.reset(graph.nodeCount()); // dist holds gScore
+    pq.reset(graph.nodeCount());
+
+    ws.set(start.id, 0, -1);
+    pq.push(start, graph.getHeuristic(start, end));
+
+    observer.log("Core: Starting A*...");
+
+    while (!pq.empty()) {
+        auto [f, curr] = pq.pop();
+
+        int currG = ws.dist(curr.id);
+        if (f > currG + graph.getHeuristic(curr, end)) continue; // Stale duplicate
+
+        res.visitedCount++;
+        observer.visited(curr);
+
+        if (curr == end) {
+            res.success = true;
+            break;
+        }
+
+        graph.forEachNeighbor(curr, [&](Node target, int weight) {
+            int tentative_gScore = currG + weight;
+            if (tentative_gScore < ws.dist(target.id)) {
+                ws.set(target.id, tentative_gScore, curr.id);
+                int fScore = tentative_gScore + graph.getHeuristic(target, end);
+                pq.push(target, fScore);
+                observer.logWith([&] { return "Core: Node " + std::to_string(target.id) + " fScore: " + std::to_string(fScore); });
+            }
+        });
+    }
+
+    res.path = reconstructPath(ws, start, end);
+    if (res.success) {
+        observer.log("Path reconstruction complete.");
+        res.totalCost = ws.dist(end.id);
+    } else {
+        observer.log("Failure: No path could be found to target.");
+    }
+
+    res.timeMs = elapsedMs(startTime);
+    return res;
+}
+
+// Bidirectional Dijkstra (UseHeuristic = false) or bidirectional A* (true).
+// The forward search runs from start over outgoing edges, the backward search
+// from end over incoming edges (forEachPredecessor), always expanding the side
+// with the smaller queue key. A* uses the symmetric average potentials
+// pf(v) = (h(v, end) - h(start, v)) / 2 and pb = -pf, kept in doubled integer
+// keys, which are consistent in both directions whenever h is. With pf + pb = 0
+// the search may stop once topF + topB >= best meeting cost (doubled for A*).
+template <typename Queue, bool UseHeuristic, typename Graph, typename Observer>
+AlgoResult bidirectionalSearch(const Graph& graph, Node start, Node end, const Observer& observer) {
+    SearchWorkspace fwd, bwd;
+    Queue qf, qb;
+    return bidirectionalSearch<UseHeuristic>(graph, start, end, observer, fwd, bwd, qf, qb);
+}
+
+template <bool UseHeuristic, typename Graph, typename Observer, typename Queue>
+AlgoResult bidirectionalSearch(const Graph& graph, Node start, Node end, const Observer& observer,
+                               SearchWorkspace& fwd, SearchWorkspace& bwd, Queue& qf, Queue& qb) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    AlgoResult res = { {}, 0, 0, 0, false };
+
+    const int n = graph.nodeCount();
+    fwd.reset(n); // bwd.parent points one step closer to end
+    bwd.reset(n);
+    qf.reset(n);
+    qb.reset(n);
+
+    auto potential = [&](Node v) { return UseHeuristic ? graph.getHeuristic(v, end) - graph.getHeuristic(start, v) : 0; };
+    auto keyF = [&](Node v, int g) { return UseHeuristic ? 2 * g + potential(v) : g; };
+    auto keyB = [&](Node v, int g) { return UseHeuristic ? 2 * g - potential(v) : g; };
+    const int scale = UseHeuristic ? 2 : 1;
+
+    int best = SearchWorkspace::INF;
+    int meet = -1;
+
+    fwd.set(start.id, 0, -1);
+    qf.push(start, keyF(start, 0));
+    bwd.set(end.id, 0, -1);
+    qb.push(end, keyB(end, 0));
+
+    observer.log(UseHeuristic ? "Core: Starting bidirectional A*..." : "Core: Starting bidirectional Dijkstra...");
+
+    while (!qf.empty() && !qb.empty()) {
+        int topF = qf.topKey();
+        int topB = qb.topKey();
+        if (best != SearchWorkspace::INF && (long long)topF + topB >= (long long)scale * best) break;
+
+        bool forward = topF <= topB;
+        SearchWorkspace& self = forward ? fwd : bwd;
+        SearchWorkspace& other = forward ? bwd : fwd;
+        auto [key, curr] = (forward ? qf : qb).pop();
+        if (key != (forward ? keyF(curr, self.dist(curr.id)) : keyB(curr, self.dist(curr.id)))) continue; // Stale duplicate
+
+        res.visitedCount++;
+        observer.visited(curr);
+
+        int d = self.dist(curr.id);
+        if (other.reached(curr) && d + other.dist(curr.id) < best) {
+            best = d + other.dist(curr.id);
+            meet = curr.id;
+        }
+
+        auto relax = [&](Node target, int weight) {
+            int newDist = d + weight;
+            if (newDist < self.dist(target.id)) {
+                self.set(target.id, newDist, curr.id);
+                if (forward) qf.push(target, keyF(target, newDist));
+                else qb.push(target, keyB(target, newDist));
+            }
+            if (other.reached(target) && self.dist(target.id) + other.dist(target.id) < best) {
+                best = self.dist(target.id) + other.dist(target.id);
+                meet = target.id;
+            }
+        };
+        if (forward) graph.forEachNeighbor(curr, relax);
+        else graph.forEachPredecessor(curr, relax);
+    }
+
+    if (meet != -1) {
+        res.success = true;
+        res.totalCost = best;
+        res.path = reconstructPath(fwd, start, { meet });
+        for (int v = bwd.parent(meet); v != -1; v = bwd.parent(v)) res.path.push_back({ v });
+        observer.logWith([&] { return "Core: Searches met at node " + std::to_string(meet) + ", cost " + std::to_string(best); });
+    } else {
+        observer.log("Failure: No path could be found to target.");
+    }
+
+    res.timeMs = elapsedMs(startTime);
+    return res;
+}
+
+// Multi-source Dijkstra with no target, writing straight into dense output arrays
+// (dist INF / parent -1 where unreached). Reverse walks incoming edges, so dist
+// becomes the cost of reaching the nearest source and parent the next step there.
+// Returns the number of nodes settled.
+template <bool Reverse, typename Graph, typename Queue>
+int distanceFieldSearch(const Graph& graph, const std::vector<Node>& sources, std::vector<int>& dist, std::vector<int>& parent, Queue& pq) {
+    const int n = graph.nodeCount();
+    dist.assign(n, SearchWorkspace::INF);
+    parent.assign(n, -1);
+    pq.reset(n);
+    for (Node s : sources) {
+        if (s.id < 0 || s.id >= n || dist[s.id] == 0) continue;
+        dist[s.id] = 0;
+        pq.push(s, 0);
+    }
+
+    int settled = 0;
+    while (!pq.empty()) {
+        auto [d, curr] = pq.pop();
+        if (d > dist[curr.id]) continue; // Stale duplicate
+        settled++;
+        auto relax = [&](Node target, int weight) {
+            int newDist = d + weight;
+            if (newDist < dist[target.id]) {
+                dist[target.id] = newDist;
+                parent[target.id] = curr.id;
+                pq.push(target, newDist);
+            }
+        };
+        if (Reverse) graph.forEachPredecessor(curr, relax);
+        else graph.forEachNeighbor(curr, relax);
+    }
+    return settled;
+}
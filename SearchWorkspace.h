@@ -0,0 +1,44 @@
+#pragma once
+#include "IGraph.h"
+#include <vector>
+#include <limits>
+#include <cstdint>
+
+// Dense per-query bookkeeping, indexed directly by Node::id.
+// Node ids must lie in [0, graph.nodeCount()), which holds for Grid::toNode.
+// Every entry records the generation that wrote it and anything older reads as
+// unreached, so reset() on a workspace of the same size is O(1). Batches of
+// queries reuse one workspace instead of reallocating per query.
+class SearchWorkspace {
+public:
+    static constexpr int INF = std::numeric_limits<int>::max();
+
+    void reset(int nodeCount) {
+        if ((int)m_entries.size() != nodeCount) {
+            m_entries.assign(nodeCount, Entry());
+            m_generation = 0;
+        }
+        if (++m_generation == 0) { // Wrapped: clear the stamps once every 2^32 queries
+            for (auto& e : m_entries) e.stamp = 0;
+            m_generation = 1;
+        }
+    }
+
+    // Best known cost (gScore for A*), INF if unreached
+    int dist(int id) const { return m_entries[id].stamp == m_generation ? m_entries[id].dist : INF; }
+    // Predecessor node id, -1 if none
+    int parent(int id) const { return m_entries[id].stamp == m_generation ? m_entries[id].parent : -1; }
+    void set(int id, int dist, int parent) { m_entries[id] = { dist, parent, m_generation }; }
+
+    bool reached(Node n) const { return m_entries[n.id].stamp == m_generation; }
+
+private:
+    // Interleaved so a relaxation touches one cache line
+    struct Entry {
+        int dist = INF;
+        int parent = -1;
+        uint32_t stamp = 0;
+    };
+    std::vector<Entry> m_entries;
+    uint32_t m_generation = 0;
+};
@@ -0,0 +1,357 @@
+#include "Wavefront.h"
+#include "SearchKernels.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WAVEFRONT_SSE2 1
+#include <emmintrin.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+namespace {
+
+// Far below INT_MAX so INF plus a few steps never overflows
+constexpr int32_t INF = 0x3FFFFFFF;
+
+// Each Ops type is one register of L int32 lanes, lane 0 at the lowest address.
+// Masks are all-ones (-1) or zero per lane. shiftUp<S> moves lanes toward higher
+// addresses (lane i gets lane i - S) and shiftDown<S> toward lower ones, the
+// vacated lanes taking fill.
+#if defined(__AVX2__)
+struct Ops {
+    static constexpr int L = 8;
+    static constexpr const char* name = "avx2";
+    using V = __m256i;
+    static V load(const int32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static void store(int32_t* p, V v) { _mm256_storeu_si256((__m256i*)p, v); }
+    static V set1(int32_t x) { return _mm256_set1_epi32(x); }
+    static V setRamp(int32_t a, int32_t step) {
+        return _mm256_setr_epi32(a, a + step, a + 2 * step, a + 3 * step, a + 4 * step, a + 5 * step, a + 6 * step, a + 7 * step);
+    }
+    static V add(V a, V b) { return _mm256_add_epi32(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_epi32(a, b); }
+    static V min(V a, V b) { return _mm256_min_epi32(a, b); }
+    static V orv(V a, V b) { return _mm256_or_si256(a, b); }
+    static V select(V mask, V ifSet, V ifClear) { return _mm256_blendv_epi8(ifClear, ifSet, mask); }
+    template <int S>
+    static V shiftUp(V v, V fill) {
+        V moved = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 1 - S, 2 - S, 3 - S, 4 - S, 5 - S, 6 - S, 7 - S));
+        return _mm256_blend_epi32(moved, fill, (1 << S) - 1);
+    }
+    template <int S>
+    static V shiftDown(V v, V fill) {
+        V moved = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(S, 1 + S, 2 + S, 3 + S, 4 + S, 5 + S, 6 + S, 7));
+        return _mm256_blend_epi32(moved, fill, 0xFF & ~((1 << (8 - S)) - 1));
+    }
+    static V broadcastFirst(V v) { return _mm256_permutevar8x32_epi32(v, _mm256_setzero_si256()); }
+    static V broadcastLast(V v) { return _mm256_permutevar8x32_epi32(v, _mm256_set1_epi32(7)); }
+    static bool any(V v) { return !_mm256_testz_si256(v, v); }
+};
+#elif defined(__SSE4_1__) || defined(WAVEFRONT_SSE2)
+struct Ops {
+    static constexpr int L = 4;
+#if defined(__SSE4_1__)
+    static constexpr const char* name = "sse4.1";
+#else
+    static constexpr const char* name = "sse2";
+#endif
+    using V = __m128i;
+    static V load(const int32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static void store(int32_t* p, V v) { _mm_storeu_si128((__m128i*)p, v); }
+    static V set1(int32_t x) { return _mm_set1_epi32(x); }
+    static V setRamp(int32_t a, int32_t step) { return _mm_setr_epi32(a, a + step, a + 2 * step, a + 3 * step); }
+    static V add(V a, V b) { return _mm_add_epi32(a, b); }
+    static V sub(V a, V b) { return _mm_sub_epi32(a, b); }
+    static V orv(V a, V b) { return _mm_or_si128(a, b); }
+#if defined(__SSE4_1__)
+    static V min(V a, V b) { return _mm_min_epi32(a, b); }
+    static V select(V mask, V ifSet, V ifClear) { return _mm_blendv_epi8(ifClear, ifSet, mask); }
+    static bool any(V v) { return !_mm_testz_si128(v, v); }
+#else
+    static V select(V mask, V ifSet, V ifClear) { return _mm_or_si128(_mm_and_si128(mask, ifSet), _mm_andnot_si128(mask, ifClear)); }
+    static V min(V a, V b) { return select(_mm_cmpgt_epi32(a, b), b, a); }
+    static bool any(V v) { return _mm_movemask_epi8(_mm_cmpeq_epi32(v, _mm_setzero_si128())) != 0xFFFF; }
+#endif
+    template <int S>
+    static V shiftUp(V v, V fill) { return _mm_or_si128(_mm_slli_si128(v, 4 * S), _mm_srli_si128(fill, 16 - 4 * S)); }
+    template <int S>
+    static V shiftDown(V v, V fill) { return _mm_or_si128(_mm_srli_si128(v, 4 * S), _mm_slli_si128(fill, 16 - 4 * S)); }
+    static V broadcastFirst(V v) { return _mm_shuffle_epi32(v, 0x00); }
+    static V broadcastLast(V v) { return _mm_shuffle_epi32(v, 0xFF); }
+};
+#elif defined(__wasm_simd128__)
+struct Ops {
+    static constexpr int L = 4;
+    static constexpr const char* name = "simd128";
+    using V = v128_t;
+    static V load(const int32_t* p) { return wasm_v128_load(p); }
+    static void store(int32_t* p, V v) { wasm_v128_store(p, v); }
+    static V set1(int32_t x) { return wasm_i32x4_splat(x); }
+    static V setRamp(int32_t a, int32_t step) { return wasm_i32x4_make(a, a + step, a + 2 * step, a + 3 * step); }
+    static V add(V a, V b) { return wasm_i32x4_add(a, b); }
+    static V sub(V a, V b) { return wasm_i32x4_sub(a, b); }
+    static V min(V a, V b) { return wasm_i32x4_min(a, b); }
+    static V orv(V a, V b) { return wasm_v128_or(a, b); }
+    static V select(V mask, V ifSet, V ifClear) { return wasm_v128_bitselect(ifSet, ifClear, mask); }
+    // Shuffle indices 4..7 pick from fill
+    template <int S>
+    static V shiftUp(V v, V fill) {
+        if constexpr (S == 1) return wasm_i32x4_shuffle(v, fill, 4, 0, 1, 2);
+        else return wasm_i32x4_shuffle(v, fill, 4, 5, 0, 1);
+    }
+    template <int S>
+    static V shiftDown(V v, V fill) {
+        if constexpr (S == 1) return wasm_i32x4_shuffle(v, fill, 1, 2, 3, 4);
+        else return wasm_i32x4_shuffle(v, fill, 2, 3, 4, 5);
+    }
+    static V broadcastFirst(V v) { return wasm_i32x4_shuffle(v, v, 0, 0, 0, 0); }
+    static V broadcastLast(V v) { return wasm_i32x4_shuffle(v, v, 3, 3, 3, 3); }
+    static bool any(V v) { return wasm_v128_any_true(v); }
+};
+#else
+// One lane: the same sweeps, one cell at a time
+struct Ops {
+    static constexpr int L = 1;
+    static constexpr const char* name = "scalar";
+    using V = int32_t;
+    static V load(const int32_t* p) { return *p; }
+    static void store(int32_t* p, V v) { *p = v; }
+    static V set1(int32_t x) { return x; }
+    static V setRamp(int32_t a, int32_t) { return a; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V min(V a, V b) { return std::min(a, b); }
+    static V orv(V a, V b) { return a | b; }
+    static V select(V mask, V ifSet, V ifClear) { return mask ? ifSet : ifClear; }
+    template <int S>
+    static V shiftUp(V, V fill) { return fill; }
+    template <int S>
+    static V shiftDown(V, V fill) { return fill; }
+    static V broadcastFirst(V v) { return v; }
+    static V broadcastLast(V v) { return v; }
+    static bool any(V v) { return v != 0; }
+};
+#endif
+
+using V = Ops::V;
+constexpr int L = Ops::L;
+
+// Padded copy of the grid: one row of INF above and below, one column on the
+// left and enough on the right to fill the last register and feed the diagonal
+// loads. Padding counts as wall, so it never changes and never passes anything on.
+struct Plane {
+    int width, height, stride;
+    std::vector<int32_t> dist;
+    std::vector<int32_t> wall; // -1 on walls and padding, 0 on open cells
+
+    Plane(const Grid& grid) : width(grid.getWidth()), height(grid.getHeight()) {
+        stride = (width + L - 1) / L * L + 2;
+        dist.assign((size_t)stride * (height + 2), INF);
+        wall.assign(dist.size(), -1);
+        for (int x = 0; x < height; ++x) {
+            int32_t* w = row(wall, x);
+            for (int y = 0; y < width; ++y) w[y] = grid.isObstacle(x, y) ? -1 : 0;
+        }
+    }
+    // Cell (x, 0) of a row; x = -1 and x = height are the padding rows
+    int32_t* row(std::vector<int32_t>& plane, int x) { return plane.data() + (size_t)(x + 1) * stride + 1; }
+};
+
+// Segmented min-plus scan of one register, toward higher lanes if Up: every open
+// lane takes min(own, lane k steps back + 10 * k) as long as no wall lies in
+// between. wall comes back as "some wall at or behind this lane".
+template <bool Up, int S>
+inline void scanStep(V& x, V& wall) {
+    const V inf = Ops::set1(INF), zero = Ops::set1(0), step = Ops::set1(10 * S);
+    V from = Up ? Ops::template shiftUp<S>(x, inf) : Ops::template shiftDown<S>(x, inf);
+    x = Ops::select(wall, x, Ops::min(x, Ops::add(from, step)));
+    wall = Ops::orv(wall, Up ? Ops::template shiftUp<S>(wall, zero) : Ops::template shiftDown<S>(wall, zero));
+}
+
+template <bool Up>
+inline void scanRegister(V& x, V& wall) {
+    if constexpr (L > 1) scanStep<Up, 1>(x, wall);
+    if constexpr (L > 2) scanStep<Up, 2>(x, wall);
+    if constexpr (L > 4) scanStep<Up, 4>(x, wall);
+}
+
+// Register offsets [lo, hi] within a row, empty when lo > hi
+struct Span {
+    int lo = INT_MAX, hi = -1;
+    bool empty() const { return lo > hi; }
+    void add(int c) { lo = std::min(lo, c); hi = std::max(hi, c); }
+    void add(const Span& s) { lo = std::min(lo, s.lo); hi = std::max(hi, s.hi); }
+};
+
+// Relaxes row x from the row at x + from (from = -1 on the top-down sweep, +1 on
+// the bottom-up one) over the registers in pull, then along the row both ways.
+// Unless full is set the row was relaxed along itself before, so each scan stops
+// at the first register past the changes that stays put. Returns the registers
+// that changed.
+template <bool Diagonal>
+Span relaxRow(Plane& plane, int x, int from, Span pull, bool full) {
+    int32_t* row = plane.row(plane.dist, x);
+    const int32_t* other = plane.row(plane.dist, x + from);
+    const int32_t* wall = plane.row(plane.wall, x);
+    const int end = plane.stride - 2;
+    const V ten = Ops::set1(10), fourteen = Ops::set1(14);
+    const V rampUp = Ops::setRamp(10, 10), rampDown = Ops::setRamp(10 * L, -10);
+    Span changed;
+
+    // From the neighbouring row, then left to right, carrying the last lane into the next register
+    V carry = Ops::set1(INF);
+    bool moved = false;
+    for (int c = pull.lo; c < end && (c <= pull.hi || moved); c += L) {
+        V old = Ops::load(row + c);
+        V w = Ops::load(wall + c);
+        V cand = Ops::add(Ops::load(other + c), ten);
+        if (Diagonal) cand = Ops::min(cand, Ops::add(Ops::min(Ops::load(other + c - 1), Ops::load(other + c + 1)), fourteen));
+        V v = Ops::select(w, old, Ops::min(old, cand));
+        scanRegister<true>(v, w);
+        v = Ops::select(w, v, Ops::min(v, Ops::add(carry, rampUp)));
+        carry = Ops::broadcastLast(v);
+        moved = Ops::any(Ops::sub(old, v));
+        if (moved) {
+            Ops::store(row + c, v);
+            changed.add(c);
+        }
+    }
+    if (changed.empty() && !full) return changed;
+
+    // Right to left from the last change, on through the register left of the first one
+    const int stop = full ? 0 : changed.lo - L;
+    carry = Ops::set1(INF);
+    moved = false;
+    for (int c = full ? end - L : changed.hi; c >= 0 && (c >= stop || moved); c -= L) {
+        V old = Ops::load(row + c);
+        V w = Ops::load(wall + c);
+        V v = old;
+        scanRegister<false>(v, w);
+        v = Ops::select(w, v, Ops::min(v, Ops::add(carry, rampDown)));
+        carry = Ops::broadcastFirst(v);
+        moved = Ops::any(Ops::sub(old, v));
+        if (moved) {
+            Ops::store(row + c, v);
+            changed.add(c);
+        }
+    }
+    return changed;
+}
+
+// Alternating top-down and bottom-up sweeps. The first one relaxes every row in
+// full; after that a row is only pulled from a neighbour over the registers that
+// neighbour changed since, so late sweeps along long, winding corridors only touch
+// the few cells the front is still moving through. Once a whole sweep changes
+// nothing, every edge is relaxed and the distances are exact.
+template <bool Diagonal>
+void sweep(Plane& plane) {
+    const int height = plane.height;
+    const int end = plane.stride - 2;
+    const Span full = { 0, end - L };
+    // Indexed by row + 1: changes not yet pulled by the row below / above (none on the padding rows)
+    std::vector<Span> toBelow(height + 2), toAbove(height + 2, full);
+    toAbove.front() = toAbove.back() = Span{};
+    for (int pass = 0;; ++pass) {
+        bool down = pass % 2 == 0;
+        bool any = false;
+        for (int i = 0; i < height; ++i) {
+            int x = down ? i : height - 1 - i;
+            int from = down ? -1 : 1;
+            Span& pending = down ? toBelow[x + 1 + from] : toAbove[x + 1 + from];
+            Span pull = full;
+            if (pass > 0) {
+                if (pending.empty()) continue;
+                pull = pending;
+                // Diagonal pulls reach one cell past the changes on either side
+                if (Diagonal) pull = { std::max(0, pull.lo - L), std::min(end - L, pull.hi + L) };
+            }
+            pending = Span{};
+            Span changed = relaxRow<Diagonal>(plane, x, from, pull, pass == 0);
+            if (!changed.empty()) {
+                toBelow[x + 1].add(changed);
+                toAbove[x + 1].add(changed);
+                any = true;
+            }
+        }
+        if (pass > 0 && !any) return;
+    }
+}
+
+} // namespace
+
+const char* wavefrontIsa() { return Ops::name; }
+
+bool computeWavefrontField(const Grid& grid, const std::vector<Node>& sources, DistanceField& out,
+                           FieldMode mode, bool withParents) {
+    if (!grid.hasUniformWeights()) return false;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    const int width = grid.getWidth(), height = grid.getHeight();
+    const int n = grid.nodeCount();
+
+    Plane plane(grid);
+    // A source on a wall can step off it, but nothing can step onto it: it feeds its
+    // neighbours when searching from the sources and nobody when searching toward them
+    std::vector<int> wallSources;
+    for (Node s : sources) {
+        if (s.id < 0 || s.id >= n) continue;
+        int x = s.id / width, y = s.id % width;
+        if (mode == FieldMode::ToSources && plane.row(plane.wall, x)[y]) wallSources.push_back(s.id);
+        else plane.row(plane.dist, x)[y] = 0;
+    }
+    if (grid.getAllowDiagonals()) sweep<true>(plane);
+    else sweep<false>(plane);
+
+    out.dist.resize(n);
+    out.reachedCount = 0;
+    for (int x = 0; x < height; ++x) {
+        const int32_t* row = plane.row(plane.dist, x);
+        int* dist = out.dist.data() + (size_t)x * width;
+        for (int y = 0; y < width; ++y) {
+            dist[y] = row[y] == INF ? -1 : row[y];
+            out.reachedCount += row[y] != INF;
+        }
+    }
+    for (int id : wallSources) {
+        out.reachedCount += out.dist[id] < 0;
+        out.dist[id] = 0;
+    }
+
+    if (!withParents) {
+        out.parent.clear();
+        out.direction.clear();
+        out.timeMs = elapsedMs(startTime);
+        return true;
+    }
+    // Any neighbour one edge closer: the step taken toward the sources, or the one
+    // the node was reached from. Walls only qualify when they are sources searched from.
+    static constexpr int dx[] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+    static constexpr int dy[] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+    static constexpr int cost[] = { 10, 10, 10, 10, 14, 14, 14, 14 };
+    const int dirs = grid.getAllowDiagonals() ? 8 : 4;
+    out.parent.assign(n, -1);
+    for (int v = 0; v < n; ++v) {
+        int d = out.dist[v];
+        if (d <= 0) continue;
+        int x = v / width, y = v % width;
+        for (int i = 0; i < dirs; ++i) {
+            int nx = x + dx[i], ny = y + dy[i];
+            if (!grid.isValid(nx, ny)) continue;
+            int u = grid.toNode(nx, ny).id;
+            if (out.dist[u] < 0 || out.dist[u] + cost[i] != d) continue;
+            if (mode == FieldMode::ToSources && plane.row(plane.wall, nx)[ny]) continue;
+            out.parent[v] = u;
+            break;
+        }
+    }
+    updateFieldDirections(grid, out);
+
+    out.timeMs = elapsedMs(startTime);
+    return true;
+}
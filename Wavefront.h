@@ -0,0 +1,28 @@
+#pragma once
+#include "DistanceField.h"
+#include "Grid.h"
+
+// Distance fields on unit-weight grids without a priority queue: raster sweeps
+// that relax whole rows at once in SIMD registers. A top-down sweep pulls each
+// row from the row above (straight for 10, diagonally for 14), then runs a
+// left-to-right and a right-to-left scan along the row that walls interrupt.
+// A bottom-up sweep does the same from the row below. Sweeps alternate until
+// nothing changes, so the result is exact (the same dist as computeDistanceField)
+// with any walls; after the first sweep only the stretches of a row next to
+// changed cells are revisited. Open maps settle in a couple of sweeps, while
+// winding corridors need one per turn back and are better left to Dijkstra/BFS.
+//
+// Lanes come from the build: AVX2 (-mavx2), SSE4.1 (-msse4.1) or plain SSE2
+// on x86, SIMD128 under Emscripten with -msimd128, scalar otherwise.
+//
+// Only for grids where every cell has weight 1 (Grid::hasUniformWeights);
+// returns false and leaves out untouched otherwise. Costs are 10 per straight
+// and 14 per diagonal step, as in the other searches. parent (and so direction)
+// is only filled when withParents is set: the first neighbour in Grid order on a
+// shortest path, which may differ from Dijkstra's pick on ties. Without it,
+// extractFieldPath reads paths from dist alone.
+bool computeWavefrontField(const Grid& grid, const std::vector<Node>& sources, DistanceField& out,
+                           FieldMode mode = FieldMode::ToSources, bool withParents = true);
+
+// Name of the instruction set the sweeps were compiled for
+const char* wavefrontIsa();
@@ -0,0 +1,61 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(int threads) {
+    if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    m_threadCount = std::max(threads, 1);
+    for (int i = 1; i < m_threadCount; ++i) m_threads.emplace_back(&WorkerPool::threadMain, this, i);
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_jobLock);
+        m_stop = true;
+    }
+    m_jobReady.notify_all();
+    for (auto& t : m_threads) t.join();
+}
+
+void WorkerPool::threadMain(int self) {
+    unsigned seen = 0;
+    while (true) {
+        const std::function<void(int)>* job;
+        {
+            std::unique_lock<std::mutex> lock(m_jobLock);
+            m_jobReady.wait(lock, [&] { return m_stop || m_jobGeneration != seen; });
+            if (m_stop) return;
+            seen = m_jobGeneration;
+            job = m_job;
+        }
+        (*job)(self);
+        {
+            std::lock_guard<std::mutex> lock(m_jobLock);
+            if (--m_busy == 0) m_jobDone.notify_one();
+        }
+    }
+}
+
+void WorkerPool::run(const std::function<void(int)>& job) {
+    {
+        std::lock_guard<std::mutex> lock(m_jobLock);
+        m_job = &job;
+        m_busy = m_threadCount - 1;
+        ++m_jobGeneration;
+    }
+    m_jobReady.notify_all();
+    job(0);
+    std::unique_lock<std::mutex> lock(m_jobLock);
+    m_jobDone.wait(lock, [&] { return m_busy == 0; });
+}
+
+void WorkerPool::barrier() {
+    unsigned phase = m_phase.load(std::memory_order_acquire);
+    if (m_waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == m_threadCount) {
+        m_waiting.store(0, std::memory_order_relaxed);
+        m_phase.fetch_add(1, std::memory_order_release);
+        return;
+    }
+    for (int spins = 0; m_phase.load(std::memory_order_acquire) == phase; ++spins) {
+        if (spins >= 64) std::this_thread::yield();
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads shared by the parallel engines. run() hands one job to
+// every worker at once, the calling thread included as worker 0, and returns
+// when all of them have finished it. Inside a job, barrier() lines the workers
+// up between phases. Needs real threads: in a Wasm build without pthreads use
+// threads = 1, which never starts a thread.
+class WorkerPool {
+public:
+    explicit WorkerPool(int threads = 0); // 0 = hardware concurrency
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int threadCount() const { return m_threadCount; }
+
+    // Runs job(self) for every self in [0, threadCount()). One job at a time.
+    void run(const std::function<void(int)>& job);
+
+    // Spins (then yields, so oversubscribed runs still progress) until every
+    // worker of the current job has arrived. Writes made before it are visible after it.
+    void barrier();
+
+private:
+    void threadMain(int self);
+
+    int m_threadCount = 1;
+    std::vector<std::thread> m_threads;
+
+    // Current job, published under m_jobLock
+    std::mutex m_jobLock;
+    std::condition_variable m_jobReady;
+    std::condition_variable m_jobDone;
+    unsigned m_jobGeneration = 0;
+    int m_busy = 0;
+    bool m_stop = false;
+    const std::function<void(int)>* m_job = nullptr;
+
+    std::atomic<int> m_waiting{ 0 };
+    std::atomic<unsigned> m_phase{ 0 };
+};
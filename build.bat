@@ -10,7 +10,7 @@ if exist "C:\msys64\ucrt64\bin\g++.exe" (
 
 
 echo Building GUI application...
-"%CXX%" -o dijikstra.exe main.cpp Grid.cpp Algorithms.cpp GraphUtils.cpp -lgdi32 -luser32 -lcomdlg32 -static
+"%CXX%" -o dijikstra.exe main.cpp Grid.cpp GridFile.cpp MappedFile.cpp MazeGenerator.cpp Algorithms.cpp BatchSearch.cpp JumpPointSearch.cpp GraphUtils.cpp DStarLite.cpp -lgdi32 -luser32 -lcomdlg32 -static
 if %errorlevel% neq 0 (
     echo Compilation Failed!
     exit /b %errorlevel%
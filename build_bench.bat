@@ -0,0 +1,18 @@
+@echo off
+REM Try to find g++ in common MSYS2 location if not in PATH
+if exist "C:\msys64\ucrt64\bin\g++.exe" (
+    set "CXX=C:\msys64\ucrt64\bin\g++.exe"
+) else if exist "C:\Program Files\CodeBlocks\MinGW\bin\g++.exe" (
+    set "CXX=C:\Program Files\CodeBlocks\MinGW\bin\g++.exe"
+) else (
+    set "CXX=g++"
+)
+
+REM Extra flags go through CXXFLAGS, e.g. set CXXFLAGS=-mavx2 for 8-lane wavefront sweeps
+echo Building headless benchmark...
+"%CXX%" -O2 -std=c++17 %CXXFLAGS% -o benchmark.exe Benchmark.cpp Grid.cpp MazeGenerator.cpp Algorithms.cpp BatchSearch.cpp ParallelQueryEngine.cpp DistanceField.cpp DeltaStepping.cpp ParallelBFS.cpp WorkerPool.cpp Wavefront.cpp JumpPointSearch.cpp ContractionHierarchy.cpp Landmarks.cpp DStarLite.cpp HierarchicalPathfinder.cpp CsrGraph.cpp MappedFile.cpp -static
+if %errorlevel% neq 0 (
+    echo Compilation Failed!
+    exit /b %errorlevel%
+)
+echo Compilation Successful. Run benchmark.exe --help for options.
@@ -0,0 +1,10 @@
+#!/bin/sh
+# Builds the headless benchmark (no Win32 / Emscripten needed).
+# Extra flags go through CXXFLAGS, e.g. CXXFLAGS=-mavx2 for 8-lane wavefront sweeps.
+CXX=${CXX:-g++}
+echo "Building benchmark..."
+"$CXX" -O2 -std=c++17 -pthread $CXXFLAGS -o benchmark Benchmark.cpp Grid.cpp MazeGenerator.cpp Algorithms.cpp BatchSearch.cpp ParallelQueryEngine.cpp DistanceField.cpp DeltaStepping.cpp ParallelBFS.cpp WorkerPool.cpp Wavefront.cpp JumpPointSearch.cpp ContractionHierarchy.cpp Landmarks.cpp DStarLite.cpp HierarchicalPathfinder.cpp CsrGraph.cpp MappedFile.cpp || {
+    echo "Compilation Failed!"
+    exit 1
+}
+echo "Compilation Successful. Run ./benchmark --help for options."
@@ -62,7 +62,7 @@ if %errorlevel% neq 0 (
     exit /b 1
 )
 
-call emcc Bindings.cpp Grid.cpp Algorithms.cpp GraphUtils.cpp -o dijkstra.js -s WASM=1 -s ALLOW_MEMORY_GROWTH=1 --bind -O3 -std=c++17
+call emcc Bindings.cpp Grid.cpp MazeGenerator.cpp Algorithms.cpp BatchSearch.cpp DistanceField.cpp Wavefront.cpp JumpPointSearch.cpp GraphUtils.cpp DStarLite.cpp -o dijkstra.js -s WASM=1 -s ALLOW_MEMORY_GROWTH=1 --bind -O3 -std=c++17 -msimd128
 if %errorlevel% neq 0 (
     echo [ERROR] Compilation Failed!
     pause
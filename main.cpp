@@ -10,14 +10,21 @@
 #include <vector>
 #include <chrono>
 #include <thread>
+#include <memory>
 #include <mutex> // Fix missing mutex header
 #include <algorithm> // For min/max
 #include "Grid.h"
 #include "Algorithms.h"
 #include "GraphUtils.h"
+#include "JumpPointSearch.h"
+#include "PathOverlay.h"
+#include "GridFile.h"
+#include "DStarLite.h"
 
 // Global Grid
 Grid* g_grid = nullptr;
+PathOverlay g_overlay; // Visited/current/path marks of the last run, drawn over the grid
+std::unique_ptr<DStarLite> g_planner; // Incremental planner over g_grid, kept across runs
 const int CELL_SIZE = 25;
 const int GRID_OFFSET_X = 20;
 const int GRID_OFFSET_Y = 80; // Lowered to make room for controls
@@ -109,6 +116,10 @@ void DrawGrid(HDC hdc) {
             
             HBRUSH brush = NULL;
             char type = g_grid->getChar(r, c);
+            if (type == '.') {
+                char mark = g_overlay.get(g_grid->toNode(r, c));
+                if (mark != PathOverlay::NONE) type = mark;
+            }
             
             int weight = g_grid->getWeight(r, c);
             if (type == '.' && weight > 1) {
@@ -158,12 +169,12 @@ class WindowsObserver : public IAlgorithmObserver {
     int m_updateCounter = 0;
 public:
     WindowsObserver(HWND hwnd) : m_hwnd(hwnd) {}
+    unsigned capabilities() const override { return VISITED | LOG; }
     void onNodeVisited(Node n) override {
         if (g_grid) {
             std::lock_guard<std::mutex> lock(g_gridMutex);
-            Point p = g_grid->toPoint(n);
-            g_grid->setVisited(p.x, p.y);
-            g_grid->setCurrent(p.x, p.y);
+            g_overlay.setVisited(n);
+            g_overlay.setCurrent(n);
         }
         
         m_updateCounter++;
@@ -266,6 +277,19 @@ void UpdateScrollBars(HWND hwnd) {
     SetScrollInfo(hwnd, SB_VERT, &si, TRUE);
 }
 
+// Save dialog hook: lpstrDefExt is only read when the dialog closes, so keep it
+// in step with the filter ("Text Files" is index 2, the others save binary)
+UINT_PTR CALLBACK SaveDialogHook(HWND hdlg, UINT uMsg, WPARAM, LPARAM lParam) {
+    if (uMsg == WM_NOTIFY) {
+        LPOFNOTIFY notify = (LPOFNOTIFY)lParam;
+        if (notify->hdr.code == CDN_TYPECHANGE) {
+            const wchar_t* ext = notify->lpOFN->nFilterIndex == 2 ? L"txt" : L"grid";
+            SendMessage(GetParent(hdlg), CDM_SETDEFEXT, 0, (LPARAM)ext);
+        }
+    }
+    return 0;
+}
+
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
     switch (uMsg) {
         case WM_CREATE:
@@ -285,6 +309,8 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             SendMessage(g_hCombo, CB_ADDSTRING, 0, (LPARAM)L"Dijkstra");
             SendMessage(g_hCombo, CB_ADDSTRING, 0, (LPARAM)L"BFS");
             SendMessage(g_hCombo, CB_ADDSTRING, 0, (LPARAM)L"A* (A-Star)");
+            SendMessage(g_hCombo, CB_ADDSTRING, 0, (LPARAM)L"Jump Point Search");
+            SendMessage(g_hCombo, CB_ADDSTRING, 0, (LPARAM)L"D* Lite (incremental)");
             SendMessage(g_hCombo, CB_SETCURSEL, 0, 0); // Default Dijkstra
 
             CreateWindow(L"BUTTON", L"RUN", WS_TABSTOP | WS_VISIBLE | WS_CHILD | BS_DEFPUSHBUTTON,
@@ -330,10 +356,14 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                     break;
                 case ID_BTN_GEN_MAZE:
                     {
-                        std::lock_guard<std::mutex> lock(g_gridMutex);
-                        g_grid->generateRandomMaze();
+                        uint64_t seed;
+                        {
+                            std::lock_guard<std::mutex> lock(g_gridMutex);
+                            seed = g_grid->generateRandomMaze();
+                            g_overlay.clear();
+                        }
+                        LogToConsole("Random Maze Generated (seed " + std::to_string(seed) + ").");
                     }
-                    LogToConsole("Random Maze Generated.");
                     InvalidateRect(hwnd, NULL, TRUE);
                     break;
                 case ID_CHK_DIAGONAL:
@@ -347,8 +377,10 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                 case ID_BTN_RESET:
                     {
                         std::lock_guard<std::mutex> lock(g_gridMutex);
+                        g_planner.reset();
                         delete g_grid;
                         g_grid = new Grid(20, 30); 
+                        g_overlay.reset(g_grid->nodeCount());
                     }
                     LogToConsole("Grid Reset.");
                     InvalidateRect(hwnd, NULL, TRUE);
@@ -362,15 +394,17 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                         ofn.hwndOwner = hwnd;
                         ofn.lpstrFile = szFile;
                         ofn.nMaxFile = sizeof(szFile);
-                        ofn.lpstrFilter = L"Text Files\0*.txt\0All Files\0*.*\0";
+                        ofn.lpstrFilter = L"Binary Grid\0*.grid\0Text Files\0*.txt\0All Files\0*.*\0";
+                        ofn.lpstrDefExt = L"grid"; // Follows the filter, see SaveDialogHook
                         ofn.nFilterIndex = 1;
-                        ofn.Flags = OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST | OFN_OVERWRITEPROMPT;
+                        ofn.lpfnHook = SaveDialogHook;
+                        ofn.Flags = OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST | OFN_OVERWRITEPROMPT | OFN_EXPLORER | OFN_ENABLEHOOK;
                         if (GetSaveFileName(&ofn)) {
+                            // Text only when explicitly chosen; binary is far smaller and faster to load
+                            bool binary = ofn.nFilterIndex != 2;
                             std::lock_guard<std::mutex> lock(g_gridMutex);
-                            std::string data = g_grid->serialize();
-                            std::ofstream out(szFile);
-                            out << data;
-                            LogToConsole("Grid Saved.");
+                            if (saveGridFile(*g_grid, szFile, binary)) LogToConsole(binary ? "Grid Saved (binary)." : "Grid Saved (text).");
+                            else LogToConsole("Error saving grid file.");
                         }
                     }
                     break;
@@ -383,18 +417,18 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                         ofn.hwndOwner = hwnd;
                         ofn.lpstrFile = szFile;
                         ofn.nMaxFile = sizeof(szFile);
-                        ofn.lpstrFilter = L"Text Files\0*.txt\0All Files\0*.*\0";
+                        ofn.lpstrFilter = L"Grid Files\0*.grid;*.txt\0All Files\0*.*\0";
                         ofn.nFilterIndex = 1;
                         ofn.Flags = OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST;
                         if (GetOpenFileName(&ofn)) {
-                            std::ifstream in(szFile);
-                            std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
                             std::lock_guard<std::mutex> lock(g_gridMutex);
-                            if (g_grid->load(data)) {
+                            GridLoadError error;
+                            if (loadGridFile(*g_grid, szFile, &error)) {
+                                g_overlay.reset(g_grid->nodeCount());
                                 LogToConsole("Grid Loaded.");
                                 InvalidateRect(hwnd, NULL, TRUE);
                             } else {
-                                LogToConsole("Error loading grid file.");
+                                LogToConsole("Error loading grid file at byte " + std::to_string(error.offset) + ": " + error.message);
                             }
                         }
                     }
@@ -405,8 +439,8 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                         break;
                     }
                     {
-                        std::lock_guard<std::mutex> lock(g_gridMutex); // Lock grid for initial clear
-                        g_grid->clearPath();
+                        std::lock_guard<std::mutex> lock(g_gridMutex); // Lock overlay for initial clear
+                        g_overlay.reset(g_grid->nodeCount());
                     }
                     InvalidateRect(hwnd, NULL, TRUE); // Clear path visually
                     
@@ -424,17 +458,19 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                             AlgoResult res;
                             if (algoIdx == 0) res = runDijkstra(*g_grid, startNode, endNode, &g_observer);
                             else if (algoIdx == 1) res = runBFS(*g_grid, startNode, endNode, &g_observer);
-                            else res = runAStar(*g_grid, startNode, endNode, &g_observer);
+                            else if (algoIdx == 2) res = runAStar(*g_grid, startNode, endNode, &g_observer);
+                            else if (algoIdx == 3) res = runJPS(*g_grid, startNode, endNode, &g_observer);
+                            else {
+                                // Repairs the previous run's search after the edits made since
+                                if (!g_planner) g_planner = std::make_unique<DStarLite>(*g_grid);
+                                res = g_planner->plan(startNode, endNode, &g_observer);
+                                LogToConsole("D* Lite expanded " + std::to_string(res.visitedCount) + " nodes.");
+                            }
                             
                             {
                                 std::lock_guard<std::mutex> lock(g_gridMutex);
                                 if (res.success) {
-                                    // Make sure to convert Node path to Point path for Grid
-                                    std::vector<Point> points;
-                                    for(const auto& n : res.path) {
-                                        points.push_back(g_grid->toPoint(n));
-                                    }
-                                    g_grid->markPath(points);
+                                    g_overlay.markPath(res.path);
                                 }
                             }
                             g_algoRunning = false;
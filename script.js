@@ -46,15 +46,12 @@ class GridFallback {
     getSource() { return this.source; }
     getDestination() { return this.dest; }
     isValid(r, c) { return r >= 0 && r < this.rows && c >= 0 && c < this.cols; }
-    clearPath() {
-        for (let r = 0; r < this.rows; r++)
-            for (let c = 0; c < this.cols; c++)
-                if (this.data[r][c] === '*' || this.data[r][c] === 'v') this.data[r][c] = '.';
-    }
-    generateRandomMaze() {
+    generateRandomMaze(kind, seed) {
+        // Fallback only knows the random-walls generator
         for (let r = 0; r < this.rows; r++)
             for (let c = 0; c < this.cols; c++)
                 if (this.data[r][c] === '.' && Math.random() < 0.3) this.data[r][c] = '#';
+        return seed;
     }
     serialize() {
         let s = `${this.rows},${this.cols},${this.source.x},${this.source.y},${this.dest.x},${this.dest.y}|`;
@@ -198,9 +195,10 @@ function setupUIListeners() {
 
     document.getElementById('btnRun').addEventListener('click', runAlgorithm);
     document.getElementById('btnMaze').addEventListener('click', () => {
-        console.log("Generating Random Maze (Dual Mode:", dualMode, ")");
-        grid.clearPath();
-        grid.generateRandomMaze();
+        const kind = parseInt(document.getElementById('mazeSelect').value);
+        const seed = (Math.random() * 0xFFFFFFFF) >>> 0 || 1;
+        console.log("Generating Random Maze (Dual Mode:", dualMode, ", kind:", kind, ", seed:", seed, ")");
+        grid.generateRandomMaze(kind, seed);
         drawGrid();
     });
     document.getElementById('btnReset').addEventListener('click', () => {
@@ -231,7 +229,9 @@ function setupUIListeners() {
         if (!file) return;
         const reader = new FileReader();
         reader.onload = (event) => {
-            const content = event.target.result;
+            // Read as bytes so binary maps survive; Wasm's load detects the format itself
+            const bytes = new Uint8Array(event.target.result);
+            const content = grid.delete ? bytes : new TextDecoder().decode(bytes);
             if (grid.load(content)) {
                 // If dimensions changed, we might need a new Wasm grid or update local ones
                 // For simplicity, we assume grid dimensions match or load handles resize.
@@ -241,7 +241,7 @@ function setupUIListeners() {
                 alert("Failed to load grid file.");
             }
         };
-        reader.readAsText(file);
+        reader.readAsArrayBuffer(file);
     });
 }
 
@@ -557,7 +557,7 @@ function solveAStarJS(grid) {
 
         if (curr.x === endPt.x && curr.y === endPt.y) break;
 
-        visited.push(curr);
+        visited.push(curr.x * cols + curr.y);
 
         const dirs = [
             { dx: -1, dy: 0, cost: 10 }, { dx: 1, dy: 0, cost: 10 },
@@ -598,25 +598,59 @@ function solveAStarJS(grid) {
     path.reverse();
 
     return {
-        path: { size: () => path.length, get: (i) => path[i] },
-        visited: { size: () => visited.length, get: (i) => visited[i] },
+        path: Int32Array.from(path, p => p.x * cols + p.y),
+        visited: Int32Array.from(visited),
         totalCost: gScore[endPt.x][endPt.y],
         timeMs: performance.now() - start
     };
 }
 
+// Copies the Int32Array views of a Wasm result out of Wasm memory (one bulk copy each)
+// and frees the C++ object. Node ids are x * width + y.
+function takeWasmResult(res) {
+    const out = {
+        path: res.pathView().slice(),
+        visited: res.visitedView().slice(),
+        timeMs: res.timeMs,
+        success: res.success
+    };
+    res.delete();
+    return out;
+}
+
+function idToPoint(id, width) {
+    return { x: Math.floor(id / width), y: id % width };
+}
+
+// D* Lite state for the current grid, kept across runs so edits are repaired
+// rather than searched from scratch. Replaced whenever the grid object is.
+let planner = null;
+let plannerGrid = null;
+
+function plannerFor(g) {
+    if (plannerGrid !== g) {
+        if (planner) planner.delete();
+        planner = new Module.DStarLite(g);
+        plannerGrid = g;
+    }
+    return planner;
+}
+
 function runAlgorithm() {
-    grid.clearPath();
     const algo1 = document.getElementById('algoSelect').value;
     const algo2 = document.getElementById('algoSelect2').value;
 
     function solve(algoName) {
         let res;
         try {
-            if (algoName === 'dijkstra') res = Module.solveDijkstra(grid);
-            else if (algoName === 'bfs') res = Module.solveBFS(grid);
+            if (algoName === 'dijkstra') res = takeWasmResult(Module.solveDijkstra(grid));
+            else if (algoName === 'bfs') res = takeWasmResult(Module.solveBFS(grid));
+            else if (algoName === 'bidijkstra') res = takeWasmResult(Module.solveBiDijkstra(grid));
+            else if (algoName === 'biastar') res = takeWasmResult(Module.solveBiAStar(grid));
+            else if (algoName === 'jps') res = takeWasmResult(Module.solveJPS(grid));
+            else if (algoName === 'dstar') res = takeWasmResult(Module.solveDStarLite(grid, plannerFor(grid)));
             else if (algoName === 'astar') {
-                if (Module.solveAStar) res = Module.solveAStar(grid);
+                if (Module.solveAStar) res = takeWasmResult(Module.solveAStar(grid));
                 else res = solveAStarJS(grid);
             }
         } catch (e) {
@@ -628,6 +662,7 @@ function runAlgorithm() {
 
     const res1 = solve(algo1);
     const res2 = dualMode ? solve(algo2) : null;
+    const width = grid.getWidth();
 
     // Update Stats 1
     const s1 = document.getElementById('stats1');
@@ -641,18 +676,18 @@ function runAlgorithm() {
         // Assuming path is array of objects {x, y}
         // Note: Wasm path doesn't include start node cost usually (start is 0), but let's sum edge weights
         // Actually A* cost is sum of edge weights. 
-        if (res.path.size() < 2) return 0;
+        if (res.path.length < 2) return 0;
 
-        for (let i = 0; i < res.path.size() - 1; i++) {
-            let n1 = res.path.get(i);
+        for (let i = 0; i < res.path.length - 1; i++) {
+            let n1 = res.path[i];
             // This logic assumes we traverse TO n1? No, path is ordered. 
             // Cost is usually sum of entering nodes.
             // Let's just sum weights of all nodes in path excluding start?
             // Simplified: Sum of weights of nodes in path.
         }
         // Easier: Just Re-calculate simple sum of weights of path nodes
-        for (let i = 0; i < res.path.size(); i++) {
-            let p = res.path.get(i);
+        for (let i = 0; i < res.path.length; i++) {
+            let p = idToPoint(res.path[i], width);
             // Generally start node cost is 0, so maybe start at 1?
             // But for Grid weights, usually entering a cell costs its weight.
             if (i > 0) cost += grid.getWeight(p.x, p.y);
@@ -662,11 +697,11 @@ function runAlgorithm() {
 
     const cost1 = calculateWeightedCost(res1);
     const time1 = res1.timeMs;
-    const speed1 = time1 > 0 ? (res1.visited.size() / time1).toFixed(2) : "N/A";
+    const speed1 = time1 > 0 ? (res1.visited.length / time1).toFixed(2) : "N/A";
 
     document.getElementById('timeDisplay').innerText = time1.toFixed(3);
-    document.getElementById('pathDisplay').innerText = res1.path.size();
-    document.getElementById('visitedDisplay').innerText = res1.visited.size();
+    document.getElementById('pathDisplay').innerText = res1.path.length;
+    document.getElementById('visitedDisplay').innerText = res1.visited.length;
     document.getElementById('costDisplay').innerText = cost1;
     document.getElementById('speedDisplay').innerText = speed1;
 
@@ -676,11 +711,11 @@ function runAlgorithm() {
 
         const cost2 = calculateWeightedCost(res2);
         const time2 = res2.timeMs;
-        const speed2 = time2 > 0 ? (res2.visited.size() / time2).toFixed(2) : "N/A";
+        const speed2 = time2 > 0 ? (res2.visited.length / time2).toFixed(2) : "N/A";
 
         document.getElementById('timeDisplay2').innerText = time2.toFixed(3);
-        document.getElementById('pathDisplay2').innerText = res2.path.size();
-        document.getElementById('visitedDisplay2').innerText = res2.visited.size();
+        document.getElementById('pathDisplay2').innerText = res2.path.length;
+        document.getElementById('visitedDisplay2').innerText = res2.visited.length;
         document.getElementById('costDisplay2').innerText = cost2;
         document.getElementById('speedDisplay2').innerText = speed2;
     }
@@ -692,19 +727,19 @@ function runAlgorithm() {
 
     function animate() {
         let batch = 5;
-        let finished1 = i1 >= res1.visited.size();
-        let finished2 = !dualMode || (res2 && i2 >= res2.visited.size());
+        let finished1 = i1 >= res1.visited.length;
+        let finished2 = !dualMode || (res2 && i2 >= res2.visited.length);
 
         while (batch-- > 0) {
-            if (!finished1) { v1.push(res1.visited.get(i1)); i1++; }
-            if (dualMode && !finished2) { v2.push(res2.visited.get(i2)); i2++; }
-            finished1 = i1 >= res1.visited.size();
-            finished2 = !dualMode || (res2 && i2 >= res2.visited.size());
+            if (!finished1) { v1.push(idToPoint(res1.visited[i1], width)); i1++; }
+            if (dualMode && !finished2) { v2.push(idToPoint(res2.visited[i2], width)); i2++; }
+            finished1 = i1 >= res1.visited.length;
+            finished2 = !dualMode || (res2 && i2 >= res2.visited.length);
         }
 
         if (finished1 && finished2) {
-            for (let j = 0; j < res1.path.size(); j++) p1.push(res1.path.get(j));
-            if (dualMode && res2) for (let j = 0; j < res2.path.size(); j++) p2.push(res2.path.get(j));
+            for (let j = 0; j < res1.path.length; j++) p1.push(idToPoint(res1.path[j], width));
+            if (dualMode && res2) for (let j = 0; j < res2.path.length; j++) p2.push(idToPoint(res2.path[j], width));
             drawGrid(v1, p1, v2, p2);
             return;
         }